@@ -949,6 +949,48 @@ void vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xG
  */
 void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>void vTaskDeadlineSet( TaskHandle_t xTask, TickType_t xNewDeadline );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Set the absolute deadline of any task.  Ready tasks of the same priority
+ * are ordered by deadline, and the task with the earliest deadline is the one
+ * selected to run.  Tasks that never have a deadline set share their priority
+ * level in round robin fashion, after any task that has a deadline.
+ *
+ * A context switch will occur before the function returns if the change
+ * means a different task should now be running.
+ *
+ * @param xTask Handle to the task for which the deadline is being set.
+ * Passing a NULL handle results in the deadline of the calling task being set.
+ *
+ * @param xNewDeadline The absolute deadline, in ticks, of the task.
+ *
+ * \defgroup vTaskDeadlineSet vTaskDeadlineSet
+ * \ingroup TaskCtrl
+ */
+void vTaskDeadlineSet( TaskHandle_t xTask, TickType_t xNewDeadline ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>TickType_t xTaskDeadlineGet( TaskHandle_t xTask );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the deadline of the calling task being returned.
+ *
+ * @return The absolute deadline of xTask, or portMAX_DELAY if none was set.
+ *
+ * \defgroup xTaskDeadlineGet xTaskDeadlineGet
+ * \ingroup TaskCtrl
+ */
+TickType_t xTaskDeadlineGet( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>void vTaskSuspend( TaskHandle_t xTaskToSuspend );</pre>
@@ -0,0 +1,252 @@
+/*
+ * FreeRTOS V9.0.0 compatible port for a POSIX host, used by the DD_HOST_SIMULATION build.
+ *
+ * Each task gets a ucontext_t and its own host stack, the kernel's StackType_t stack only holds a
+ * pointer to that context. A SIGALRM interval timer firing every configSIM_TICK_PERIOD_US
+ * microseconds is the tick interrupt, so a 1 ms FreeRTOS tick can run faster than real time.
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef configSIM_TICK_PERIOD_US
+	#define configSIM_TICK_PERIOD_US	( 1000 )
+#endif
+
+/* Host stack of each task, independent of the stack depth the task was created with. */
+#define portHOST_STACK_SIZE				( 256 * 1024 )
+
+typedef struct HostContext
+{
+	ucontext_t xContext;
+	void *pvStack;
+} HostContext_t;
+
+/* The first member of the TCB is pxTopOfStack, which points at the task's context. */
+extern void * volatile pxCurrentTCB;
+
+static volatile UBaseType_t uxCriticalNesting = 0;
+static volatile BaseType_t xYieldPending = pdFALSE;
+static volatile BaseType_t xInsideTick = pdFALSE;
+static sigset_t xTickSignal;
+
+/*-----------------------------------------------------------*/
+
+static HostContext_t *prvGetContext( void *pxTCB )
+{
+	return *( HostContext_t ** ) ( *( StackType_t ** ) pxTCB );
+}
+/*-----------------------------------------------------------*/
+
+/* makecontext() only passes int arguments, so the task function and its parameter arrive split in halves. */
+static void prvTaskEntry( unsigned int ulCodeHigh, unsigned int ulCodeLow, unsigned int ulParamHigh, unsigned int ulParamLow )
+{
+TaskFunction_t pxCode = ( TaskFunction_t ) ( ( ( uintptr_t ) ulCodeHigh << 32 ) | ulCodeLow );
+void *pvParameters = ( void * ) ( ( ( uintptr_t ) ulParamHigh << 32 ) | ulParamLow );
+
+	uxCriticalNesting = 0;
+	sigprocmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	pxCode( pvParameters );
+
+	/* Tasks must not return. */
+	for( ;; )
+	{
+		vTaskDelete( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+HostContext_t *pxContext = malloc( sizeof( HostContext_t ) );
+
+	configASSERT( pxContext != NULL );
+	pxContext->pvStack = malloc( portHOST_STACK_SIZE );
+	configASSERT( pxContext->pvStack != NULL );
+
+	getcontext( &pxContext->xContext );
+	pxContext->xContext.uc_stack.ss_sp = pxContext->pvStack;
+	pxContext->xContext.uc_stack.ss_size = portHOST_STACK_SIZE;
+	pxContext->xContext.uc_link = NULL;
+	sigemptyset( &pxContext->xContext.uc_sigmask );
+	sigaddset( &pxContext->xContext.uc_sigmask, SIGALRM );
+	makecontext( &pxContext->xContext, ( void ( * )( void ) ) prvTaskEntry, 4,
+			( unsigned int ) ( ( uintptr_t ) pxCode >> 32 ), ( unsigned int ) ( uintptr_t ) pxCode,
+			( unsigned int ) ( ( uintptr_t ) pvParameters >> 32 ), ( unsigned int ) ( uintptr_t ) pvParameters );
+
+	*pxTopOfStack = ( StackType_t ) pxContext;
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+HostContext_t *pxContext = prvGetContext( pxTCB );
+
+	free( pxContext->pvStack );
+	free( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+/* Must be called with the tick signal masked. */
+static void prvSwitchContext( void )
+{
+void *pxPreviousTCB = pxCurrentTCB;
+
+	vTaskSwitchContext();
+	if( pxPreviousTCB != pxCurrentTCB )
+	{
+		swapcontext( &prvGetContext( pxPreviousTCB )->xContext, &prvGetContext( pxCurrentTCB )->xContext );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+sigset_t xPrevious;
+
+	/* A yield requested inside a critical section or the tick is taken when that ends. */
+	if( xInsideTick != pdFALSE || uxCriticalNesting > 0 )
+	{
+		xYieldPending = pdTRUE;
+		return;
+	}
+
+	sigprocmask( SIG_BLOCK, &xTickSignal, &xPrevious );
+	xYieldPending = pdFALSE;
+	prvSwitchContext();
+	sigprocmask( SIG_SETMASK, &xPrevious, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	sigprocmask( SIG_BLOCK, &xTickSignal, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	if( xInsideTick == pdFALSE )
+	{
+		sigprocmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+sigset_t xPrevious;
+
+	sigprocmask( SIG_BLOCK, &xTickSignal, &xPrevious );
+	return ( UBaseType_t ) sigismember( &xPrevious, SIGALRM );
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+	if( uxMask == 0 )
+	{
+		sigprocmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	if( xInsideTick != pdFALSE )
+	{
+		return;
+	}
+
+	sigprocmask( SIG_BLOCK, &xTickSignal, NULL );
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( xInsideTick != pdFALSE )
+	{
+		return;
+	}
+
+	if( uxCriticalNesting > 0 )
+	{
+		uxCriticalNesting--;
+	}
+
+	if( uxCriticalNesting == 0 )
+	{
+		if( xYieldPending != pdFALSE )
+		{
+			xYieldPending = pdFALSE;
+			prvSwitchContext();
+		}
+		sigprocmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* SIGALRM handler, the kernel blocks the signal while it runs. */
+static void prvTickHandler( int lSignal )
+{
+BaseType_t xSwitchRequired;
+
+	( void ) lSignal;
+
+	xInsideTick = pdTRUE;
+	xSwitchRequired = xTaskIncrementTick();
+	xInsideTick = pdFALSE;
+
+	if( xSwitchRequired != pdFALSE || xYieldPending != pdFALSE )
+	{
+		xYieldPending = pdFALSE;
+		prvSwitchContext();
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xAction;
+struct itimerval xTimer;
+
+	memset( &xAction, 0, sizeof( xAction ) );
+	xAction.sa_handler = prvTickHandler;
+	sigemptyset( &xAction.sa_mask );
+	xAction.sa_flags = SA_RESTART;
+	sigaction( SIGALRM, &xAction, NULL );
+
+	xTimer.it_interval.tv_sec = 0;
+	xTimer.it_interval.tv_usec = configSIM_TICK_PERIOD_US;
+	xTimer.it_value = xTimer.it_interval;
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+
+	/* Start the first task, this never returns. */
+	setcontext( &prvGetContext( pxCurrentTCB )->xContext );
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+/* Runs before main(): the tick signal set exists before the first task is created and output is line buffered. */
+__attribute__(( constructor )) static void prvPortInit( void )
+{
+	sigemptyset( &xTickSignal );
+	sigaddset( &xTickSignal, SIGALRM );
+	setvbuf( stdout, NULL, _IOLBF, 0 );
+}
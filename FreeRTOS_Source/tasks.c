@@ -153,6 +153,43 @@ a statically allocated stack and a dynamically allocated TCB. */
 	#define static
 #endif
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+	/* Value of xDeadline for tasks that are not scheduled by deadline.  It sorts
+	after every real deadline so such tasks queue behind deadline tasks of the
+	same priority. */
+	#define taskNO_DEADLINE		portMAX_DELAY
+
+	/* Ready lists are kept ordered by absolute deadline, so the earliest deadline
+	task at a priority is always the head entry.  Lists that only hold tasks
+	without a deadline still share the processor in round robin fashion. */
+	#define taskGET_OWNER_OF_READY_LIST( pxTCB, pxList )										\
+	{																						\
+		if( listGET_ITEM_VALUE_OF_HEAD_ENTRY( ( pxList ) ) != taskNO_DEADLINE )				\
+		{																					\
+			( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( ( pxList ) );							\
+		}																					\
+		else																				\
+		{																					\
+			listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), ( pxList ) );							\
+		}																					\
+	}
+
+	/* A readied task preempts the running task if it has a higher priority, or
+	the same priority and an earlier deadline. */
+	#define taskSHOULD_PREEMPT( pxTCB )																\
+		( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||									\
+		  ( ( ( pxTCB )->uxPriority == pxCurrentTCB->uxPriority ) && ( ( pxTCB )->xDeadline < pxCurrentTCB->xDeadline ) ) )
+
+#else
+
+	#define taskGET_OWNER_OF_READY_LIST( pxTCB, pxList ) listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), ( pxList ) )
+	#define taskSHOULD_PREEMPT( pxTCB ) ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 	/* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
@@ -184,7 +221,7 @@ a statically allocated stack and a dynamically allocated TCB. */
 																										\
 		/* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of						\
 		the	same priority get an equal share of the processor time. */									\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
+		taskGET_OWNER_OF_READY_LIST( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
 		uxTopReadyPriority = uxTopPriority;																\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
@@ -214,7 +251,7 @@ a statically allocated stack and a dynamically allocated TCB. */
 		/* Find the highest priority list that contains ready tasks. */								\
 		portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );								\
 		configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );		\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );		\
+		taskGET_OWNER_OF_READY_LIST( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );		\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 	/*-----------------------------------------------------------*/
@@ -252,6 +289,22 @@ count overflows. */
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/*
+ * Place the task represented by pxTCB into the appropriate ready list for
+ * the task.  It is inserted in deadline order, behind tasks with the same
+ * deadline.
+ */
+#define prvAddTaskToReadyList( pxTCB )																\
+	traceMOVED_TASK_TO_READY_STATE( pxTCB );														\
+	taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );												\
+	listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), ( pxTCB )->xDeadline );				\
+	vListInsert( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
+
+#else
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
@@ -261,6 +314,8 @@ count overflows. */
 	taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );												\
 	vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
 	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
+
+#endif /* configUSE_EDF_SCHEDULING */
 /*-----------------------------------------------------------*/
 
 /*
@@ -317,6 +372,10 @@ typedef struct tskTaskControlBlock
 		UBaseType_t		uxTaskNumber;		/*< Stores a number specifically for use by third party trace code. */
 	#endif
 
+	#if ( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xDeadline;			/*< Absolute deadline used to order the task within its ready list.  taskNO_DEADLINE if the task has none. */
+	#endif
+
 	#if ( configUSE_MUTEXES == 1 )
 		UBaseType_t		uxBasePriority;		/*< The priority last assigned to the task - used by the priority inheritance mechanism. */
 		UBaseType_t		uxMutexesHeld;
@@ -857,6 +916,12 @@ UBaseType_t x;
 	}
 
 	pxNewTCB->uxPriority = uxPriority;
+	#if ( configUSE_EDF_SCHEDULING == 1 )
+	{
+		pxNewTCB->xDeadline = taskNO_DEADLINE;
+	}
+	#endif /* configUSE_EDF_SCHEDULING */
+
 	#if ( configUSE_MUTEXES == 1 )
 	{
 		pxNewTCB->uxBasePriority = uxPriority;
@@ -1561,6 +1626,80 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+	void vTaskDeadlineSet( TaskHandle_t xTask, TickType_t xNewDeadline )
+	{
+	TCB_t *pxTCB;
+
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the deadline of the calling
+			task that is being changed. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			if( pxTCB->xDeadline != xNewDeadline )
+			{
+				pxTCB->xDeadline = xNewDeadline;
+
+				/* A blocked or suspended task picks up the new deadline when it
+				is next added to a ready list.  A ready task is re-inserted so
+				its ready list stays in deadline order. */
+				if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+				{
+					if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+					{
+						portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+					prvAddTaskToReadyList( pxTCB );
+
+					/* The running task may no longer have the earliest deadline,
+					or the modified task may now preempt it. */
+					if( ( pxTCB == pxCurrentTCB ) || ( taskSHOULD_PREEMPT( pxTCB ) != pdFALSE ) )
+					{
+						taskYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+	TickType_t xTaskDeadlineGet( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+	TickType_t xReturn;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			xReturn = pxTCB->xDeadline;
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
 	void vTaskSuspend( TaskHandle_t xTaskToSuspend )
@@ -2470,7 +2609,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 					/* Preemption is on, but a context switch should only be
 					performed if the unblocked task has a priority that is
 					equal to or higher than the currently executing task. */
-					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					if( taskSHOULD_PREEMPT( pxTCB ) )
 					{
 						/* Pend the yield to be performed when the scheduler
 						is unsuspended. */
@@ -2612,7 +2751,14 @@ BaseType_t xSwitchRequired = pdFALSE;
 		writer has not explicitly turned time slicing off. */
 		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
 		{
-			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+			#if ( configUSE_EDF_SCHEDULING == 1 )
+				/* A list headed by a deadline task always selects its head again,
+				so time slicing only applies to lists of tasks without a deadline. */
+				if( ( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 ) &&
+					( listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) == taskNO_DEADLINE ) )
+			#else
+				if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+			#endif
 			{
 				xSwitchRequired = pdTRUE;
 			}
@@ -2925,7 +3071,7 @@ BaseType_t xReturn;
 		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
 	}
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskSHOULD_PREEMPT( pxUnblockedTCB ) )
 	{
 		/* Return true if the task removed from the event list has a higher
 		priority than the calling task.  This allows the calling task to know if
@@ -2983,7 +3129,7 @@ BaseType_t xReturn;
 	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
 	prvAddTaskToReadyList( pxUnblockedTCB );
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskSHOULD_PREEMPT( pxUnblockedTCB ) )
 	{
 		/* Return true if the task removed from the event list has
 		a higher priority than the calling task.  This allows
@@ -4420,7 +4566,7 @@ TickType_t uxReturn;
 				}
 				#endif
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4538,7 +4684,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4628,7 +4774,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
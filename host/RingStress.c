@@ -0,0 +1,81 @@
+/*
+ * 	RingStress.c
+ *  Host stress test of the scheduler command ring: several pthread producers push numbered commands
+ *  while one consumer pops them, checking that nothing is lost and each producer's order is kept.
+ *  Producers run unserialised on every host core and yield between reserving and publishing now and then,
+ *  so pushes interleave at the CAS and consumers meet reserved but unpublished slots.
+ */
+
+#include <Ring.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define RING_STRESS_PRODUCERS		(4)
+#define RING_STRESS_COMMANDS		(200000)
+
+static ddRing_t ring;
+static long wakes;
+static long stalls;
+static __thread long reserved;
+
+/*
+ * Push hook between reserve and publish, gives the core away on every 64th push of a producer
+ */
+void Ring_Stress_Reserved(void) {
+	if((++reserved & 63) == 0) sched_yield();
+}
+
+/*
+ * Pushes RING_STRESS_COMMANDS commands tagged with the producer's ID and a sequence number
+ */
+static void* Produce(void* argument) {
+	long id = (long)argument;
+
+	for(long i = 0; i < RING_STRESS_COMMANDS; i++) {
+		messageHandle message = {CREATE, (TaskHandle_t)id, (void*)i, 0};
+		bool wake = false;
+		while(!Push_DD_Ring(&ring, &message, &wake)) sched_yield();
+		if(wake) __atomic_add_fetch(&wakes, 1, __ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+int main(void) {
+	pthread_t producers[RING_STRESS_PRODUCERS];
+	long next[RING_STRESS_PRODUCERS] = {0};
+	long received = 0;
+	long idle = 0;
+	messageHandle message;
+
+	Init_DD_Ring(&ring);
+	for(long i = 0; i < RING_STRESS_PRODUCERS; i++) pthread_create(&producers[i], NULL, Produce, (void*)i);
+
+	while(received < RING_STRESS_PRODUCERS * RING_STRESS_COMMANDS) {
+		if(Pop_DD_Ring(&ring, &message)) {
+			long id = (long)message.sender;
+			if((long)message.data != next[id]) {
+				printf("Producer %ld: expected command %ld, got %ld\n", id, next[id], (long)message.data);
+				return 1;
+			}
+			next[id]++;
+			received++;
+			idle = 0;
+			continue;
+		}
+
+		// A slot reserved but not yet published reads as empty, the producer holding it signals once it publishes
+		if(__atomic_load_n(&ring.head, __ATOMIC_RELAXED) != ring.tail) stalls++;
+
+		// Announce a sleep the way the scheduler does, a producer that finds the flag set counts a wake
+		if(Sleep_DD_Ring(&ring)) Wake_DD_Ring(&ring);
+		sched_yield();
+		if(++idle == 10000000) {
+			printf("Ring stalled after %ld commands\n", received);
+			return 1;
+		}
+	}
+
+	for(long i = 0; i < RING_STRESS_PRODUCERS; i++) pthread_join(producers[i], NULL);
+	printf("Ring stress passed: %ld commands from %d producers, %ld wakes, %ld pops behind an unpublished slot\n", received, RING_STRESS_PRODUCERS, wakes, stalls);
+	return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * 	Accounting.c
+ *  Measures the execution time, preemptions, response time and lateness of every deadline-driven job.
+ */
+
+#include <Accounting.h>
+#ifndef DD_HOST_SIMULATION
+// The bundled CMSIS core header predates the DWT definitions, so the cycle counter registers are mapped here
+# define DD_DWT_CTRL						(*(volatile uint32_t*)0xE0001000UL)
+# define DD_DWT_CYCCNT						(*(volatile uint32_t*)0xE0001004UL)
+# define DD_DWT_CTRL_CYCCNTENA				(1UL << 0)
+#endif
+
+// Aggregates per task ID, only written by the scheduler task
+static ddAccountStats_t accountStats[DD_ACCOUNTED_TASKS];
+
+// Job switched out while still ready, counted as preempted if the same context switch picks another task
+static ddTaskHandle switchedOut;
+
+#ifdef DD_HOST_SIMULATION
+// Simulated cycle count and the simulated time it was last brought up to
+static uint64_t hostCycles;
+static uint64_t hostCyclesTime;
+#endif
+
+
+/*
+ * Returns the free-running cycle counter, which wraps so only differences are meaningful.
+ * The host advances it by simulated time scaled to the simulated core clock. The switch hooks call it
+ * as well as tasks, so the tick signal is masked while the time is sampled and the count brought up to it.
+ */
+uint32_t Get_DD_Cycles(void) {
+#ifndef DD_HOST_SIMULATION
+	return DD_DWT_CYCCNT;
+#else
+	UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	uint64_t time = Get_DD_Simulated_Ns();
+	hostCycles += (time - hostCyclesTime) * Get_DD_Core_Clock() / DD_FULL_SPEED_HZ;
+	hostCyclesTime = time;
+	uint32_t cycles = (uint32_t)hostCycles;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+	return cycles;
+#endif
+}
+
+/*
+ * Starts the cycle counter and clears the aggregates, must run before the first job is released
+ */
+void Init_DD_Accounting(void) {
+#ifndef DD_HOST_SIMULATION
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DD_DWT_CYCCNT = 0;
+	DD_DWT_CTRL |= DD_DWT_CTRL_CYCCNTENA;
+#endif
+	memset(accountStats, 0, sizeof(accountStats));
+#ifdef DD_HOST_SIMULATION
+	hostCycles = 0;
+	hostCyclesTime = Get_DD_Simulated_Ns();
+#endif
+}
+
+/*
+ * Task switch hook, stamps the dispatch of the job the incoming task is running
+ */
+void Switched_In_DD_Task(void* handle, void* tag) {
+	ddTaskHandle task = (ddTaskHandle)tag;
+
+	// A time slice that hands the core straight back to the same task is no preemption
+	if(switchedOut != NULL && (void*)switchedOut->handle != handle) switchedOut->account.preemptions++;
+	switchedOut = NULL;
+
+	// A pool record reused by a job of another task is left alone
+	if(task == NULL || !task->account.running || (void*)task->handle != handle) return;
+	task->account.dispatched = Get_DD_Cycles();
+	if(task->account.dispatches++ == 0) task->account.started = Get_DD_Time_Us();
+}
+
+/*
+ * Task switch hook, charges the time since the last dispatch to the job the outgoing task is running.
+ * A job leaving the core while still ready is latched for the switch-in hook to count as preempted.
+ */
+void Switched_Out_DD_Task(void* handle, void* tag, int ready) {
+	ddTaskHandle task = (ddTaskHandle)tag;
+
+	if(task == NULL || !task->account.running || (void*)task->handle != handle) return;
+	task->account.execution += Get_DD_Cycles() - task->account.dispatched;
+	if(ready) switchedOut = task;
+}
+
+/*
+ * Opens the account of a job reaching the scheduler. Its microsecond deadline counts from the start of the
+ * tick it was ideally released in, as marked on the time base by the tick interrupt, so it also orders jobs
+ * whose deadlines fall in the same tick.
+ */
+void Start_DD_Account(ddTaskHandle task) {
+	ddTimeUs_t now = Get_DD_Time_Us();
+	ddTimeUs_t release = Get_DD_Tick_Time_Us(task->startTime);
+	uint32_t relative = (task->spec != NULL && task->spec->deadlineUs != 0) ? task->spec->deadlineUs : (task->deadline - task->startTime) * DD_US_PER_TICK;
+
+	taskENTER_CRITICAL();
+	task->account.completed = 0;
+	task->account.deadline = release + relative;
+	task->account.dispatched = Get_DD_Cycles();
+	task->account.dispatches = 0;
+	task->account.execution = 0;
+	task->account.lateness = 0;
+	task->account.preemptions = 0;
+	task->account.released = now;
+	task->account.response = 0;
+	task->account.running = true;
+	task->account.started = 0;
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Called by a persistent worker as it picks up a job, the worker is already running so the job is dispatched now
+ */
+void Begin_DD_Account(ddTaskHandle task) {
+	// Stamp before tagging, a switch in between still sees the previous job, which is no longer running
+	task->account.dispatched = Get_DD_Cycles();
+	task->account.started = Get_DD_Time_Us();
+	task->account.dispatches = 1;
+	vTaskSetApplicationTaskTag(NULL, (TaskHookFunction_t)task);
+}
+
+/*
+ * Closes the account of a job from its own task once the job body returned, before it reports to the scheduler
+ */
+void Stop_DD_Account(ddTaskHandle task) {
+	taskENTER_CRITICAL();
+	if(task->account.running) {
+		ddTimeUs_t now = Get_DD_Time_Us();
+		task->account.execution += Get_DD_Cycles() - task->account.dispatched;
+		task->account.completed = now;
+		task->account.response = now - task->account.released;
+		task->account.lateness = (int32_t)(now - task->account.deadline);
+		task->account.running = false;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Adds a finished job to the aggregates of its task ID, called by the scheduler when the job reports back
+ */
+void Record_DD_Account(ddTaskHandle task) {
+	if(task == NULL || task->account.running || task->account.dispatches == 0 || task->number >= DD_ACCOUNTED_TASKS) return;
+
+	ddAccountStats_t* stats = &accountStats[task->number];
+	stats->spec = task->spec;
+	stats->jobs++;
+	stats->execution += task->account.execution;
+	stats->preemptions += task->account.preemptions;
+	if(task->account.execution > stats->executionMax) stats->executionMax = task->account.execution;
+	if(task->account.response > stats->responseMax) stats->responseMax = task->account.response;
+	if(stats->jobs == 1 || task->account.lateness > stats->latenessMax) stats->latenessMax = task->account.lateness;
+}
+
+/*
+ * Copies the aggregates of one task ID, returns false if none of its jobs finished yet
+ */
+bool Get_DD_Account_Stats(uint32_t id, ddAccountStats_t* stats) {
+	if(stats == NULL || id >= DD_ACCOUNTED_TASKS || accountStats[id].jobs == 0) return false;
+
+	*stats = accountStats[id];
+	return true;
+}
+
+/*
+ * Prints the measured execution of every task next to its WCET budget, all times in microseconds
+ */
+void Print_DD_Accounting(void) {
+	ddAccountStats_t stats;
+
+	for(uint32_t id = 0; id < DD_ACCOUNTED_TASKS; id++) {
+		if(!Get_DD_Account_Stats(id, &stats)) continue;
+
+		uint32_t budget = (stats.spec == NULL) ? 0 : stats.spec->wcet * DD_US_PER_TICK;
+		printf("Task %u: %u jobs, execution mean %u max %u of %u us, response max %u us, lateness max %d us, %u preemptions\n",
+				(unsigned int)id, (unsigned int)stats.jobs,
+				(unsigned int)(stats.execution / stats.jobs / DD_CYCLES_PER_US), (unsigned int)(stats.executionMax / DD_CYCLES_PER_US),
+				(unsigned int)budget, (unsigned int)stats.responseMax, (int)stats.latenessMax, (unsigned int)stats.preemptions);
+	}
+}
@@ -0,0 +1,19 @@
+#ifndef ACCOUNTING_H_
+#define ACCOUNTING_H_
+
+#include <CommonConfig.h>
+#include <Governor.h>
+#include <Timebase.h>
+
+void Begin_DD_Account(ddTaskHandle task);
+bool Get_DD_Account_Stats(uint32_t id, ddAccountStats_t* stats);
+uint32_t Get_DD_Cycles(void);
+void Init_DD_Accounting(void);
+void Print_DD_Accounting(void);
+void Record_DD_Account(ddTaskHandle task);
+void Start_DD_Account(ddTaskHandle task);
+void Stop_DD_Account(ddTaskHandle task);
+void Switched_In_DD_Task(void* handle, void* tag);
+void Switched_Out_DD_Task(void* handle, void* tag, int ready);
+
+#endif
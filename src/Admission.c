@@ -0,0 +1,249 @@
+/*
+ * 	Admission.c
+ *  Decides whether a job can be added to the deadline-driven scheduler without breaking earlier guarantees.
+ */
+
+#include <Admission.h>
+
+/*
+ * Returns the utilisation of a periodic task scaled by DD_UTILISATION_SCALE, rounded up to stay conservative.
+ */
+uint32_t Get_DD_Spec_Utilisation(const ddTaskSpec_t* spec) {
+	return (uint32_t)(((uint64_t)spec->wcet * DD_UTILISATION_SCALE + spec->period - 1) / spec->period);
+}
+
+/*
+ * Returns the relative deadline of a task in ticks, a microsecond deadline is rounded up to whole ticks
+ */
+TickType_t Get_DD_Spec_Deadline(const ddTaskSpec_t* spec) {
+	if(spec->deadlineUs == 0) return spec->deadline;
+	return (TickType_t)((spec->deadlineUs + DD_US_PER_TICK - 1) / DD_US_PER_TICK);
+}
+
+/*
+ * Returns the admitted task running from a descriptor, or NULL if it has not been admitted.
+ */
+static ddAdmittedTask_t* Find_DD_Admitted(ddAdmission_t* admission, const ddTaskSpec_t* spec) {
+	for(uint32_t i = 0; i < admission->count; i++) {
+		if(admission->admitted[i].spec == spec) return &admission->admitted[i];
+	}
+	return NULL;
+}
+
+/*
+ * Demand bound function of a synchronous periodic task: the work of its jobs released and due within an interval.
+ */
+static uint64_t Demand_DD_Periodic(const ddTaskSpec_t* spec, uint64_t length) {
+	TickType_t deadline = Get_DD_Spec_Deadline(spec);
+	if(length < deadline) return 0;
+	return ((length - deadline) / spec->period + 1) * (uint64_t)spec->wcet;
+}
+
+/*
+ * Processor-demand test of the admitted tasks plus a candidate whose total utilisation is given.
+ * Only absolute deadlines up to the busy-period bound max(D_max, sum((T_i - D_i) U_i) / (1 - U)) need checking.
+ */
+static bool Demand_DD_Test(ddAdmission_t* admission, const ddTaskSpec_t* candidate, uint32_t utilisation) {
+	const uint32_t count = admission->count + 1;
+	uint64_t slack = 0;
+	uint64_t bound = 0;
+
+	for(uint32_t i = 0; i < count; i++) {
+		const ddTaskSpec_t* spec = (i < admission->count) ? admission->admitted[i].spec : candidate;
+		uint32_t taskUtilisation = (i < admission->count) ? admission->admitted[i].utilisation : Get_DD_Spec_Utilisation(candidate);
+
+		TickType_t deadline = Get_DD_Spec_Deadline(spec);
+
+		if(deadline < spec->period) slack += (uint64_t)(spec->period - deadline) * taskUtilisation;
+		if(deadline > bound) bound = deadline;
+		admission->nextDeadline[i] = deadline;
+	}
+
+	// At full utilisation the bound is the hyperperiod, the point limit below then decides
+	if(utilisation < DD_UTILISATION_SCALE) {
+		uint64_t busyPeriod = slack / (DD_UTILISATION_SCALE - utilisation);
+		if(busyPeriod > bound) bound = busyPeriod;
+	} else {
+		bound = UINT64_MAX;
+	}
+
+	// Walk the absolute deadlines in increasing order, the demand at each must fit in the interval
+	for(uint32_t points = 0; points < DD_DBF_MAX_POINTS; points++) {
+		uint64_t length = UINT64_MAX;
+		for(uint32_t i = 0; i < count; i++) {
+			if(admission->nextDeadline[i] < length) length = admission->nextDeadline[i];
+		}
+		if(length > bound) return true;
+
+		uint64_t demand = 0;
+		for(uint32_t i = 0; i < count; i++) {
+			const ddTaskSpec_t* spec = (i < admission->count) ? admission->admitted[i].spec : candidate;
+			demand += Demand_DD_Periodic(spec, length);
+			if(admission->nextDeadline[i] == length) admission->nextDeadline[i] += spec->period;
+		}
+#if ( DD_APERIODIC_SERVER == 1 )
+		// The server never demands more than its bandwidth over any interval
+		demand += (length * admission->server.utilisation + DD_UTILISATION_SCALE - 1) / DD_UTILISATION_SCALE;
+#endif
+		if(demand > length) return false;
+	}
+
+	// Feasibility could not be shown within the point limit, so stay on the safe side
+	return false;
+}
+
+/*
+ * Admits a new periodic task: O(1) utilisation test while every deadline equals the period,
+ * processor-demand test once any deadline is constrained.
+ */
+static bool Admit_DD_Periodic(ddAdmission_t* admission, const ddTaskSpec_t* spec) {
+	TickType_t deadline = Get_DD_Spec_Deadline(spec);
+	if(spec->wcet == 0 || spec->wcet > deadline) return false;
+	if(admission->count >= DD_MAX_ADMITTED_TASKS) return false;
+
+	uint32_t utilisation = Get_DD_Spec_Utilisation(spec);
+	if(admission->utilisation + utilisation > DD_UTILISATION_SCALE) return false;
+
+	bool constrained = admission->constrained || (deadline < spec->period);
+	if(constrained && !Demand_DD_Test(admission, spec, admission->utilisation + utilisation)) return false;
+
+	admission->admitted[admission->count].nextRelease = 0;
+	admission->admitted[admission->count].spec = spec;
+	admission->admitted[admission->count].utilisation = utilisation;
+	admission->count++;
+	admission->utilisation += utilisation;
+	admission->constrained = constrained;
+	return true;
+}
+
+#if ( DD_APERIODIC_SERVER == 1 )
+/*
+ * Total Bandwidth Server: an aperiodic job released at r gets the deadline max(r, d_prev) + C / U_s,
+ * so aperiodic work stays within the reserved bandwidth and needs no demand test of its own.
+ * The job is always scheduled by that deadline. If it is later than the one the job asked for, the
+ * requested deadline is kept as the job's hard limit and a miss of it is reported as overdue; the job
+ * is only rejected when it could not meet that limit even running alone from its release. The server
+ * only moves on to the new deadline once the job is in the heap, see Confirm_DD_Task.
+ */
+static bool Serve_DD_Aperiodic(ddAdmission_t* admission, ddTaskHandle job) {
+	TickType_t start = (admission->server.deadline > job->startTime) ? admission->server.deadline : job->startTime;
+	TickType_t deadline = start + (job->spec->wcet * admission->server.period + admission->server.budget - 1) / admission->server.budget;
+
+	if(job->startTime + job->spec->wcet > job->deadline) return false;
+
+	if(deadline > job->deadline) job->requested = job->deadline;
+	job->deadline = deadline;
+	return true;
+}
+#else
+/*
+ * Work that must complete between now and a horizon: active jobs due by then plus
+ * jobs of admitted periodic tasks that are yet to be released and due by then.
+ */
+static uint64_t Demand_DD_Window(ddAdmission_t* admission, ddHeapHandle heap, TickType_t now, TickType_t horizon) {
+	uint64_t demand = 0;
+
+	for(uint32_t i = 0; i < heap->length; i++) {
+		ddTaskHandle job = heap->nodes[i];
+		if(job->spec != NULL && job->deadline <= horizon) demand += job->spec->wcet;
+	}
+
+	for(uint32_t i = 0; i < admission->count; i++) {
+		const ddTaskSpec_t* spec = admission->admitted[i].spec;
+		TickType_t release = (admission->admitted[i].nextRelease > now) ? admission->admitted[i].nextRelease : now;
+		TickType_t deadline = Get_DD_Spec_Deadline(spec);
+		if(horizon >= release + deadline) demand += ((horizon - release - deadline) / spec->period + 1) * (uint64_t)spec->wcet;
+	}
+
+	return demand;
+}
+
+/*
+ * Admits a one-shot job: the demand must still fit at its own deadline and at every later active deadline it pushes back.
+ */
+static bool Admit_DD_Job(ddAdmission_t* admission, ddTaskHandle job, ddHeapHandle heap) {
+	TickType_t now = xTaskGetTickCount();
+	uint64_t wcet = job->spec->wcet;
+
+	if(job->deadline <= now) return false;
+	if(Demand_DD_Window(admission, heap, now, job->deadline) + wcet > job->deadline - now) return false;
+
+	for(uint32_t i = 0; i < heap->length; i++) {
+		TickType_t horizon = heap->nodes[i]->deadline;
+		if(horizon <= job->deadline) continue;
+		if(Demand_DD_Window(admission, heap, now, horizon) + wcet > horizon - now) return false;
+	}
+	return true;
+}
+#endif
+
+/*
+ * Resets the admitted task set and reserves the aperiodic server bandwidth
+ */
+void Init_DD_Admission(ddAdmission_t* admission) {
+	admission->count = 0;
+	admission->utilisation = 0;
+	admission->constrained = false;
+
+#if ( DD_APERIODIC_SERVER == 1 )
+	admission->server.budget = DD_SERVER_BUDGET;
+	admission->server.deadline = 0;
+	admission->server.period = DD_SERVER_PERIOD;
+	admission->server.utilisation = (uint32_t)(((uint64_t)DD_SERVER_BUDGET * DD_UTILISATION_SCALE + DD_SERVER_PERIOD - 1) / DD_SERVER_PERIOD);
+	admission->utilisation = admission->server.utilisation;
+#endif
+}
+
+/*
+ * Decides whether a new job may enter the active heap. The first job of a periodic task admits the task,
+ * later jobs of an admitted task are accepted, and aperiodic jobs go through the server or, without one,
+ * are checked one by one against the demand.
+ * Jobs built without a task set descriptor carry no WCET and are accepted best effort.
+ */
+bool Admit_DD_Task(ddAdmission_t* admission, ddTaskHandle task, ddHeapHandle heap) {
+	if(admission == NULL || task == NULL || heap == NULL) return false;
+	if(task->spec == NULL) return true;
+
+	const ddTaskSpec_t* spec = task->spec;
+#if ( DD_APERIODIC_SERVER == 1 )
+	if(task->type != Periodic || spec->period == 0) return Serve_DD_Aperiodic(admission, task);
+#else
+	if(task->type != Periodic || spec->period == 0) return Admit_DD_Job(admission, task, heap);
+#endif
+
+	ddAdmittedTask_t* admitted = Find_DD_Admitted(admission, spec);
+	if(admitted == NULL) {
+		if(!Admit_DD_Periodic(admission, spec)) return false;
+		admitted = &admission->admitted[admission->count - 1];
+	}
+
+	admitted->nextRelease = task->startTime + spec->period;
+	return true;
+}
+
+/*
+ * Commits an admitted job once it is in the active heap, a job that could not be inserted leaves the server as it was
+ */
+void Confirm_DD_Task(ddAdmission_t* admission, ddTaskHandle task) {
+#if ( DD_APERIODIC_SERVER == 1 )
+	if(admission == NULL || task == NULL || task->spec == NULL) return;
+	if(task->type != Periodic || task->spec->period == 0) admission->server.deadline = task->deadline;
+#else
+	( void ) admission;
+	( void ) task;
+#endif
+}
+
+/*
+ * Returns the number of periodic tasks admitted
+ */
+uint32_t Get_DD_Admitted_Tasks(ddAdmission_t* admission) {
+	return admission->count;
+}
+
+/*
+ * Returns the utilisation of the admitted periodic tasks and the server reservation in percent
+ */
+uint32_t Get_DD_Utilisation(ddAdmission_t* admission) {
+	return (uint32_t)(((uint64_t)admission->utilisation * 100) / DD_UTILISATION_SCALE);
+}
@@ -0,0 +1,14 @@
+#ifndef ADMISSION_H_
+#define ADMISSION_H_
+
+#include <CommonConfig.h>
+
+bool Admit_DD_Task(ddAdmission_t* admission, ddTaskHandle task, ddHeapHandle heap);
+void Confirm_DD_Task(ddAdmission_t* admission, ddTaskHandle task);
+uint32_t Get_DD_Admitted_Tasks(ddAdmission_t* admission);
+TickType_t Get_DD_Spec_Deadline(const ddTaskSpec_t* spec);
+uint32_t Get_DD_Spec_Utilisation(const ddTaskSpec_t* spec);
+uint32_t Get_DD_Utilisation(ddAdmission_t* admission);
+void Init_DD_Admission(ddAdmission_t* admission);
+
+#endif
@@ -7,14 +7,24 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Building with DD_HOST_SIMULATION defined targets a FreeRTOS POSIX port
+ * instead of the STM32F4 board. The kernel, the heap, the host port and the
+ * application sources in src/ are linked, see host/Makefile; the startup,
+ * CMSIS and peripheral sources stay target-only.
+ */
+#ifndef DD_HOST_SIMULATION
 #include "stm32f4xx.h"
+#endif
 #include "../FreeRTOS_Source/include/FreeRTOS.h"
 #include "../FreeRTOS_Source/include/queue.h"
 #include "../FreeRTOS_Source/include/semphr.h"
 #include "../FreeRTOS_Source/include/task.h"
 #include "../FreeRTOS_Source/include/timers.h"
 
+#ifndef DD_HOST_SIMULATION
 #include "stm32f4_discovery.h"
+#endif
 #include "FreeRTOSHooks.h"
 
 # define MIN_DD_PRIORITY        			(1)
@@ -24,6 +34,127 @@
 # define SCHEDULER_DD_PRIORITY	   			(configMAX_PRIORITIES - 1)
 # define MAX_DD_TASK_PRIORITY 				(SCHEDULER_DD_PRIORITY - 4)
 
+// Only the DD_RUNNING_SLOTS earliest-deadline tasks get distinct priorities above
+// BASE_DD_PRIORITY, every other active task parks at BASE_DD_PRIORITY
+# define DD_RUNNING_SLOTS					(4)
+# define RUNNING_DD_PRIORITY				(BASE_DD_PRIORITY + 1)
+
+#if (RUNNING_DD_PRIORITY + DD_RUNNING_SLOTS) > GENERATOR_DD_PRIORITY
+#error "DD_RUNNING_SLOTS does not fit below GENERATOR_DD_PRIORITY"
+#endif
+
+// Initial capacity of the active heap, which doubles whenever it fills up
+# define DD_INITIAL_HEAP_CAPACITY			(16)
+# define DD_NOT_IN_HEAP						(0xFFFFFFFF)
+
+// Number of ddTask_t records in the static pool, i.e. the most jobs that can be alive at once
+# define DD_TASK_POOL_SIZE					(64)
+
+// Admission control: most periodic tasks tracked, fixed-point scale of utilisations and
+// most deadlines walked by one processor-demand test before a task is rejected as unprovable
+# define DD_MAX_ADMITTED_TASKS				(32)
+# define DD_UTILISATION_SCALE				(1UL << 16)
+# define DD_DBF_MAX_POINTS					(256)
+
+// Aperiodic jobs are served by a Total Bandwidth Server with DD_SERVER_BUDGET ticks every DD_SERVER_PERIOD,
+// set DD_APERIODIC_SERVER to 0 to run them in the background below all periodic work instead
+#ifndef DD_APERIODIC_SERVER
+# define DD_APERIODIC_SERVER				(1)
+#endif
+# define DD_SERVER_BUDGET					(50)
+# define DD_SERVER_PERIOD					(500)
+
+// Synthetic job workload: calibrated over DD_WORKLOAD_CALIBRATION_TICKS ticks in chunks of DD_WORKLOAD_CHUNK units
+# define DD_WORKLOAD_CALIBRATION_TICKS		(10)
+# define DD_WORKLOAD_CHUNK					(64)
+
+// Number of independent scheduler instances, the task set is split between them by utilisation with
+// worst-fit decreasing, or first-fit decreasing if DD_PARTITION_WORST_FIT is 0. Each instance admits up to
+// a whole core and needs one of its own, so partitioning is only available on a port with DD_CORES > 1.
+// FreeRTOS V9 in this tree is single-core.
+#ifndef DD_CORES
+# define DD_CORES							(1)
+#endif
+#ifndef DD_PARTITIONS
+# define DD_PARTITIONS						(1)
+#endif
+#ifndef DD_PARTITION_WORST_FIT
+# define DD_PARTITION_WORST_FIT				(1)
+#endif
+
+#if DD_PARTITIONS > DD_CORES
+#error "DD_PARTITIONS needs a core per partition, the single-core kernel cannot guarantee more than one"
+#endif
+
+// Most tasks that can be declared as users of one shared resource
+# define DD_RESOURCE_USERS					(8)
+
+// Length of a test run in ticks, after which the scheduler reports its statistics and exits
+# define DD_RUN_DURATION					(1500)
+
+// Hashed timing wheel of job deadlines, releases stay in the dispatcher's sorted release table instead.
+// An event lives in slot (expiry % DD_WHEEL_SLOTS) and fires when that slot is passed on the round
+// containing its expiry, so DD_WHEEL_SLOTS must be a power of two and a multiple of 32
+# define DD_WHEEL_SLOTS						(256)
+# define DD_WHEEL_WORDS						(DD_WHEEL_SLOTS / 32)
+
+// Timing wheel entry, owner is the job whose deadline it tracks
+typedef struct ddEvent_t {
+    TickType_t        	expiry;
+    struct ddEvent_t* 	next;
+    void*             	owner;
+    struct ddEvent_t* 	previous;
+} ddEvent_t;
+
+typedef ddEvent_t* ddEventHandle;
+
+// Job timestamps come from a free-running 32-bit timer counting microseconds, TIM2 on target
+# define DD_US_PER_TICK						(1000000UL / configTICK_RATE_HZ)
+#ifndef DD_HOST_SIMULATION
+# define DD_TIMEBASE_TIMER					(TIM2)
+# define DD_TIMEBASE_CLOCK					(RCC_APB1Periph_TIM2)
+#endif
+
+typedef uint32_t ddTimeUs_t;
+
+// Full core clock, the governor scales down from it by dividing HCLK
+# define DD_FULL_SPEED_HZ					(168000000UL)
+# define DD_SPEED_LEVELS					(4)
+# define DD_GOVERNED_TASKS					(32)
+
+// Clock level: AHB divider of HCLK and the APB dividers that go with it
+typedef struct ddSpeed_t {
+    uint32_t			apb1;
+    uint32_t			apb2;
+    uint32_t			divisor;
+    uint32_t			hclk;
+} ddSpeed_t;
+
+// Job CPU time is counted on DWT->CYCCNT on target and in simulated nanoseconds at full speed on the host,
+// a cycle being the same work at any clock level. Aggregates are kept for the first DD_ACCOUNTED_TASKS task IDs.
+#ifndef DD_HOST_SIMULATION
+# define DD_CYCLES_PER_US					(DD_FULL_SPEED_HZ / 1000000UL)
+#else
+# define DD_CYCLES_PER_US					(1000UL)
+#endif
+# define DD_ACCOUNTED_TASKS					(32)
+
+// Timing of one job, timestamps in microseconds and CPU time in counter cycles charged by the task switch hooks while running is set
+typedef struct ddAccount_t {
+    ddTimeUs_t			completed;
+    ddTimeUs_t			deadline;
+    uint32_t			dispatched;	// Counter value when the job was last switched in
+    uint32_t			dispatches;
+    uint32_t			execution;
+    int32_t				lateness;	// Completion minus deadline in microseconds, negative when the job finished in time
+    uint32_t			preemptions;
+    ddTimeUs_t			released;
+    uint32_t			response;	// Completion minus release in microseconds
+    bool				running;
+    ddTimeUs_t			started;	// First dispatch
+} ddAccount_t;
+
+
 typedef enum taskType {
     Aperiodic,
 	Periodic,
@@ -32,21 +163,154 @@ typedef enum taskType {
 
 
 typedef struct ddTask_t {
+    ddAccount_t			account;
     TickType_t        	deadline;
+    volatile bool		deleting;	// The job's own task is deleting it, so the task outlives an overdue deadline to get its reply
+    bool				finished;	// The worker is done with the record (completed or superseded), the overdue list may free it
     TaskFunction_t    	function;
+    uint32_t			generation;	// Bumped each time the pool hands out the record, commands carry it to detect reuse
     TaskHandle_t      	handle;
+    uint32_t			heapIndex;
     const char *      	name;
     struct ddTask_t* 	next;
     uint32_t			number;
+    bool				overdue;	// Moved to the overdue list, a worker may still be running it
+    uint32_t			partition;	// Scheduler instance the job belongs to
     struct ddTask_t* 	previous;
+    TickType_t			requested;	// Deadline the job asked for when the server schedules it by a later one, else portMAX_DELAY
+    const struct ddTaskSpec_t* spec;
     TickType_t        	startTime;
-    xTimerHandle      	timer;
+    ddEvent_t      		timer;
     taskType    	  	type;
+    struct ddWorker_t*	worker;
 } ddTask_t;
 
 typedef ddTask_t* ddTaskHandle;
 
 
+// Static description of one deadline-driven task, a task set is a const table of these indexed by task ID
+typedef struct ddTaskSpec_t {
+    TickType_t        	deadline;	// Relative deadline of each job
+    uint32_t			deadlineUs;	// Relative deadline in microseconds when it is below tick granularity, 0 to use deadline.
+    								// It replaces deadline, rounded up to whole ticks for admission and overdue detection
+    TaskFunction_t    	function;	// Job body, run once per release with the job's ddTaskHandle
+    const char *      	name;
+    TickType_t        	period;		// 0 for an aperiodic task, which is released once
+    TickType_t        	phase;		// Offset of the first release from scheduler start
+    TickType_t        	wcet;		// Worst-case execution time of each job
+} ddTaskSpec_t;
+
+
+// Resource shared between deadline-driven jobs under the Stack Resource Policy. Preemption levels are relative
+// deadlines, a shorter one being a higher level, so the ceiling is the shortest relative deadline of any user.
+typedef struct ddResource_t {
+    TickType_t			ceiling;	// portMAX_DELAY until a user is declared
+    ddTaskHandle		holder;		// Job holding the resource, NULL while it is free
+    const char *		name;
+    struct ddCeiling_t*	owner;		// Scheduler instance the resource was first locked in, resources never cross partitions
+    TickType_t			saved;		// System ceiling before this resource was locked, restored when it is unlocked
+    struct ddResource_t* under;		// Resource locked before this one in the same instance
+    uint32_t			userCount;
+    const ddTaskSpec_t*	users[DD_RESOURCE_USERS];	// Tasks declared with Use_DD_Resource, only their jobs may lock it
+} ddResource_t;
+
+typedef ddResource_t* ddResourceHandle;
+
+// Stack Resource Policy state of a scheduler instance: its locked resources, most recent on top, and the system
+// ceiling they impose. A job only runs ahead of the top holder if its level is above the system ceiling.
+typedef struct ddCeiling_t {
+    volatile bool		deferred;	// The last re-rank held a job back, so unlocking has to wake the scheduler
+    TickType_t			horizon;	// Kernel EDF: holder deadline of the last re-rank that parked jobs, 0 if none
+    ddResourceHandle	locked;
+    uint32_t			parked;		// Kernel EDF: jobs the last re-rank parked below the holder
+    TickType_t			system;		// Shortest ceiling among locked resources, portMAX_DELAY if none is locked
+} ddCeiling_t;
+
+typedef ddCeiling_t* ddCeilingHandle;
+
+
+// Measured execution of every job of one task ID, used to size WCET budgets from measurements
+typedef struct ddAccountStats_t {
+    uint64_t			execution;
+    uint32_t			executionMax;
+    uint32_t			jobs;
+    int32_t				latenessMax;
+    uint32_t			preemptions;
+    uint32_t			responseMax;
+    const ddTaskSpec_t*	spec;
+} ddAccountStats_t;
+
+
+// Periodic task accepted by the admission controller, nextRelease is when its next job is due
+typedef struct ddAdmittedTask_t {
+    TickType_t        	nextRelease;
+    const ddTaskSpec_t*	spec;
+    uint32_t			utilisation;
+} ddAdmittedTask_t;
+
+
+// Bandwidth server for aperiodic jobs, deadline is the last deadline it handed out
+typedef struct ddServer_t {
+    TickType_t        	budget;
+    TickType_t        	deadline;
+    TickType_t        	period;
+    uint32_t			utilisation;
+} ddServer_t;
+
+
+// Admission state of one scheduler instance, nextDeadline is scratch space for the processor-demand test
+typedef struct ddAdmission_t {
+    ddAdmittedTask_t	admitted[DD_MAX_ADMITTED_TASKS];
+    bool				constrained;	// Set once a task with a deadline shorter than its period is admitted
+    uint32_t			count;
+    TickType_t			nextDeadline[DD_MAX_ADMITTED_TASKS + 1];
+#if ( DD_APERIODIC_SERVER == 1 )
+    ddServer_t			server;			// Reserved before any periodic task is admitted
+#endif
+    uint32_t			utilisation;	// Admitted periodic tasks and the server, scaled by DD_UTILISATION_SCALE
+} ddAdmission_t;
+
+
+// Timing wheel of pending events, occupied has one bit per non-empty slot so the next event is found a word at a time
+typedef struct ddWheel_t {
+    uint32_t        	length;
+    TickType_t        	now;
+    uint32_t        	occupied[DD_WHEEL_WORDS];
+    ddEventHandle 		slots[DD_WHEEL_SLOTS];
+} ddWheel_t;
+
+typedef ddWheel_t* ddWheelHandle;
+
+
+// Persistent FreeRTOS task that runs every job of one periodic deadline-driven task
+typedef struct ddWorker_t {
+    TaskFunction_t    	function;
+    TaskHandle_t      	handle;
+    ddTaskHandle		job;
+    const char *      	name;
+    uint32_t			partition;
+} ddWorker_t;
+
+typedef ddWorker_t* ddWorkerHandle;
+
+
+// Row of the release dispatcher's table, kept sorted by the ideal time of the next release
+typedef struct ddRelease_t {
+    TickType_t        	next;
+    const ddTaskSpec_t*	spec;
+    ddWorkerHandle		worker;
+} ddRelease_t;
+
+
+// Usage counters of the ddTask_t pool
+typedef struct ddPoolStats_t {
+    uint32_t        capacity;
+    uint32_t        failures;
+    uint32_t        highWater;
+    uint32_t        inUse;
+} ddPoolStats_t;
+
+
 typedef struct ddList_t {
     uint32_t        length;
     ddTaskHandle 	head;
@@ -56,22 +320,122 @@ typedef struct ddList_t {
 typedef ddList_t* ddListHandle;
 
 
+// Binary min-heap of active tasks keyed on deadline, running[i] holds the task ranked i among the running slots
+typedef struct ddHeap_t {
+    uint32_t        capacity;
+    uint32_t        length;
+    ddTaskHandle* 	nodes;
+    ddTaskHandle 	running[DD_RUNNING_SLOTS];
+} ddHeap_t;
+
+typedef ddHeap_t* ddHeapHandle;
+
+
 typedef enum messageCommand_t {
     CREATE,
+    CREATE_BATCH,
     DELETE,
-    ACTIVE_LIST,
-    OVERDUE_LIST
+    COMPLETE,
+    UNLOCK
 } messageCommand_t;
 
+// Jobs submitted together by one CREATE_BATCH command, rejected entries come back as NULL
+typedef struct ddBatch_t {
+    uint32_t        	count;
+    ddTaskHandle*		tasks;
+} ddBatch_t;
+
+typedef ddBatch_t* ddBatchHandle;
+
 typedef struct messageHandle {
 	messageCommand_t 	type;
     TaskHandle_t      	sender;
     void*             	data;
+    uint32_t			generation;	// DELETE and COMPLETE: generation of the job in data when the command was sent
 } messageHandle;
 
-QueueHandle_t xTask1Queue;
-QueueHandle_t xTask2Queue;
-QueueHandle_t xTask3Queue;
-QueueHandle_t xTaskAperiodicQueue;
+// Most jobs of the active heap and of the overdue list captured in a monitor snapshot
+# define DD_SNAPSHOT_ACTIVE					(32)
+# define DD_SNAPSHOT_OVERDUE				(5)
+
+typedef enum ddTaskState_t {
+    Ready,
+    Running,
+    Overdue
+} ddTaskState_t;
+
+// Fixed-size binary record of one job, 20 bytes with no padding so it can be dumped and decoded as is
+typedef struct ddTaskRecord_t {
+    uint32_t			deadline;
+    uint32_t			id;			// Task ID, the job's row in the task set table
+    uint32_t			number;		// Release index k of the job, 0 for aperiodic jobs
+    uint32_t			release;
+    uint8_t				priority;	// FreeRTOS priority the job runs at, 0 once it is overdue
+    uint8_t				state;		// ddTaskState_t
+    uint8_t				type;		// taskType
+    uint8_t				reserved;
+} ddTaskRecord_t;
+
+_Static_assert(sizeof(ddTaskRecord_t) == 20, "ddTaskRecord_t must stay 20 bytes");
+
+// Both task lists as of the last scheduler pass, sequence is odd while the scheduler is rewriting them
+typedef struct ddSnapshot_t {
+    ddTaskRecord_t		active[DD_SNAPSHOT_ACTIVE];
+    uint32_t			activeLength;
+    ddTaskRecord_t		overdue[DD_SNAPSHOT_OVERDUE];
+    uint32_t			overdueLength;
+    uint32_t			sequence;
+    TickType_t        	time;
+} ddSnapshot_t;
+
+// Slots in the lock-free command ring feeding the scheduler, a power of two
+# define DD_RING_SIZE						(64)
+
+// One ring slot, sequence tells producers and the consumer whose turn the slot is
+typedef struct ddCommandSlot_t {
+    messageHandle		message;
+    uint32_t			sequence;
+} ddCommandSlot_t;
+
+// Bounded multi-producer single-consumer ring, sleeping is set while the consumer blocks
+typedef struct ddRing_t {
+    uint32_t			head;
+    uint32_t			sleeping;
+    ddCommandSlot_t		slots[DD_RING_SIZE];
+    uint32_t			tail;
+} ddRing_t;
+
+typedef ddRing_t* ddRingHandle;
+
+// Counters one scheduler instance reports at the end of a run for throughput and deadline-miss rates
+typedef struct ddSchedulerStats_t {
+    uint32_t			jobsCompleted;
+    uint32_t			jobsOverdue;
+    uint32_t			jobsRejected;
+    uint32_t			jobsReleased;
+    uint32_t			messagesHandled;
+    TickType_t			releaseJitterMax;
+    uint64_t			releaseJitterTotal;
+} ddSchedulerStats_t;
+
+// One deadline-driven scheduler instance with its own lists, admission state and command ring
+typedef struct ddScheduler_t {
+    ddHeap_t			activeHeap;
+    ddAdmission_t		admission;
+    ddCeiling_t			ceiling;
+    ddRing_t			commandRing;
+    ddWheel_t			eventWheel;
+    TaskHandle_t		handle;
+    ddList_t			overdueList;
+    uint32_t			partition;
+    ddSnapshot_t		snapshot;	// Lists published for the monitor under a seqlock
+    bool				snapshotStale;
+    ddSchedulerStats_t	stats;
+} ddScheduler_t;
+
+// Task notification bits, the scheduler replies to the sender of a command directly
+# define DD_NOTIFY_ACCEPTED					(1UL << 0)
+# define DD_NOTIFY_REJECTED					(1UL << 1)
+# define DD_NOTIFY_RELEASE					(1UL << 2)
 
 #endif
@@ -5,246 +5,182 @@
 
 #include <Creator.h>
 
-/*
- * Creates an aperiodic task to be injected into the deadline-driven scheduler.
- */
-void AperiodicTaskCreator( void *pvParameters ) {
-	while(1) {
-	        TickType_t taskDeadline = aperiodicTaskDeadline;
-	        TickType_t curTime = xTaskGetTickCount();
-
-	        ddTaskHandle newTask = Init_DD_Task();
-	        newTask->name = "Aperiodic Task";
-	        newTask->number = 4;
-	        newTask->type = Aperiodic;
-	        newTask->function = AperiodicTask;
-	        newTask->startTime = curTime;
-	        newTask->deadline = taskDeadline + curTime;
-
-	        Create_DD_Task(newTask);
-	        vTaskDelay(portMAX_DELAY);
-	}
-}
+// Task set of the selected test bench, each entry gets a row in the release table and one worker
+const ddTaskSpec_t ddTaskSet[] = {
+	{ .name = "Periodic Task 1", .period = periodicTask1Period, .wcet = periodicTask1Duration, .deadline = periodicTask1Period, .phase = 0, .function = DD_Task_Body },
+	{ .name = "Periodic Task 2", .period = periodicTask2Period, .wcet = periodicTask2Duration, .deadline = periodicTask2Period, .phase = 0, .function = DD_Task_Body },
+	{ .name = "Periodic Task 3", .period = periodicTask3Period, .wcet = periodicTask3Duration, .deadline = periodicTask3Period, .phase = 0, .function = DD_Task_Body },
+	//{ .name = "Aperiodic Task", .period = 0, .wcet = aperiodicTaskDuration, .deadline = aperiodicTaskDeadline, .phase = 0, .function = DD_Task_Body },
+};
 
-/*
- * Runs the aperiodic task when the scheduler releases it.
- */
-void AperiodicTask (void *pvParameters) {
-	bool overdueFlag = false;
-	ddTaskHandle this = (ddTaskHandle)pvParameters;
-	TickType_t curTime, prevTime, timeLeft = 0;
-	TickType_t executionTime = aperiodicTaskDuration / portTICK_PERIOD_MS;
-
-    while(1) {
-    	// Task is released
-    	curTime = xTaskGetTickCount();
-    	prevTime = curTime;
-    	printf("\nAperiodic Task released at %u ms with priority %u\n", (unsigned int)curTime, (unsigned int)uxTaskPriorityGet( NULL ) );
-
-    	// Execute the task for its pre-set duration
-        for(int i = 0; i < executionTime; i++) {
-        	if(this->deadline < curTime) {
-				overdueFlag = true;
-				break;
-			}
-			curTime = xTaskGetTickCount();
-			if(curTime == prevTime) i--;
-			prevTime = curTime;
-		}
+const uint32_t ddTaskSetSize = sizeof(ddTaskSet) / sizeof(ddTaskSet[0]);
 
-        curTime = xTaskGetTickCount();
-    	if(overdueFlag == false) {
-    		printf("\nAperiodic task completed at %u ms", (unsigned int)curTime);
-    	} else {
-    		printf("\nAperiodic task overdue at %u ms", (unsigned int)curTime);
-    	}
+// Table the dispatcher was started from, task IDs are indices into it
+static const ddTaskSpec_t* taskSet = NULL;
 
-        // Pause the task until its deadline
-        timeLeft = this->deadline - curTime;
-        vTaskDelayUntil(&curTime, timeLeft);
+// Release table, one row per task set entry, sorted by next release with aperiodic rows dropping off the end once released
+static ddRelease_t* releaseTable = NULL;
+static uint32_t releaseCount = 0;
 
-        Delete_DD_Task(xTaskGetCurrentTaskHandle(), 'A');
-    }
-}
+// Workers indexed by task ID, they stay put while the rows pointing at them are sorted
+static ddWorker_t* workers = NULL;
 
-/*
- * Creates the 1st periodic task to be injected into the deadline-driven scheduler.
- */
-void PeriodicTaskCreator1(void *pvParameters) {
-    while(1) {
-        TickType_t taskDeadline = periodicTask1Period;
-        TickType_t curTime = xTaskGetTickCount();
-
-        ddTaskHandle newTask = Init_DD_Task();
-        newTask->name = "Periodic Task 1";
-        newTask->number = 1;
-        newTask->type = Periodic;
-        newTask->function = PeriodicTask1;
-        newTask->startTime = curTime;
-        newTask->deadline = taskDeadline + curTime;
-
-        Create_DD_Task(newTask);
-        vTaskDelay(periodicTask1Period);
-    }
-}
+// Jobs due at the current release instant and their workers, submitted to the scheduler as one batch
+static ddTaskHandle* batchTasks = NULL;
+static ddWorkerHandle* batchWorkers = NULL;
 
 /*
- * Creates the 2nd periodic task to be injected into the deadline-driven scheduler.
+ * Moves the row at index towards the back of the release table until the table is sorted again,
+ * rows with the same release time keep their order
  */
-void PeriodicTaskCreator2(void *pvParameters) {
-    while(1) {
-        TickType_t taskDeadline = periodicTask2Period;
-        TickType_t curTime = xTaskGetTickCount();
-
-        ddTaskHandle newTask = Init_DD_Task();
-        newTask->name = "Periodic Task 2";
-        newTask->number = 2;
-        newTask->type = Periodic;
-        newTask->function = PeriodicTask2;
-        newTask->startTime = curTime;
-        newTask->deadline = taskDeadline + curTime;
-
-        Create_DD_Task(newTask);
-        vTaskDelay(periodicTask2Period);
-    }
-}
+static void Sort_DD_Release(uint32_t index) {
+	ddRelease_t row = releaseTable[index];
 
-/*
- * Creates the 3rd periodic task to be injected into the deadline-driven scheduler.
- */
-void PeriodicTaskCreator3(void *pvParameters) {
-    while(1) {
-        TickType_t taskDeadline = periodicTask3Period;
-        TickType_t curTime = xTaskGetTickCount();
-
-        ddTaskHandle newTask = Init_DD_Task();
-        newTask->name = "Periodic Task 3";
-        newTask->number = 3;
-        newTask->type = Periodic;
-        newTask->function = PeriodicTask3;
-        newTask->startTime = curTime;
-        newTask->deadline = taskDeadline + curTime;
-
-        Create_DD_Task(newTask);
-        vTaskDelay(periodicTask3Period);
-    }
+	while(index + 1 < releaseCount && releaseTable[index + 1].next <= row.next) {
+		releaseTable[index] = releaseTable[index + 1];
+		index++;
+	}
+	releaseTable[index] = row;
 }
 
 /*
- * Runs the 1st periodic task when the scheduler releases it.
+ * Creates the release table and one worker per entry of a task set table, then starts the dispatcher.
+ * Each worker is bound to the scheduler instance its entry was partitioned onto. On failure every worker
+ * created so far is deleted and the tables are freed, so the task set can be started again.
  */
-void PeriodicTask1(void *pvParameters) {
-	bool overdueFlag = false;
-	ddTaskHandle this = (ddTaskHandle)pvParameters;
-	TickType_t curTime, prevTime, timeLeft = 0;
-	TickType_t executionTime = periodicTask1Duration / portTICK_PERIOD_MS;
-
-    while(1) {
-        if(timeLeft != 0) vTaskDelayUntil(&curTime, timeLeft);
-    	// Release the task
-    	curTime = xTaskGetTickCount();
-    	prevTime = curTime;
-    	printf("\nPeriodic Task 1 released at %u ms with priority %u", (unsigned int)curTime, (unsigned int)uxTaskPriorityGet( NULL ) );
-
-    	// Execute the task for its pre-set duration
-        for(int i = 0; i < executionTime; i++) {
-        	if(this->deadline < curTime) {
-				overdueFlag = true;
-				break;
-			}
-        	curTime = xTaskGetTickCount();
-			if( curTime == prevTime ) i--;
-			prevTime = curTime;
-        }
-        curTime = xTaskGetTickCount();
-    	if(overdueFlag == false) {
-    		printf("\nPeriodic Task 1 completed at %u ms", (unsigned int)curTime);
-		} else {
-			printf("\nPeriodic Task 1 overdue at %u ms", (unsigned int)curTime);
+bool Start_DD_TaskSet(const ddTaskSpec_t* set, uint32_t size) {
+	uint32_t created = 0;
+	if(set == NULL || size == 0 || taskSet != NULL) return false;
+
+	releaseTable = (ddRelease_t*)pvPortMalloc(size * sizeof(ddRelease_t));
+	workers = (ddWorker_t*)pvPortMalloc(size * sizeof(ddWorker_t));
+	batchTasks = (ddTaskHandle*)pvPortMalloc(size * sizeof(ddTaskHandle));
+	batchWorkers = (ddWorkerHandle*)pvPortMalloc(size * sizeof(ddWorkerHandle));
+	uint32_t* partitions = (uint32_t*)pvPortMalloc(size * sizeof(uint32_t));
+	if(releaseTable == NULL || workers == NULL || batchTasks == NULL || batchWorkers == NULL || partitions == NULL) goto fail;
+	taskSet = set;
+
+	if(!Partition_DD_TaskSet(set, size, partitions)) printf("Task set does not fit %u partitions, admission will reject the excess\n", (unsigned int)DD_PARTITIONS);
+
+	// Insert each row behind every row released earlier or at the same time
+	for(uint32_t i = 0; i < size; i++) {
+		if(set[i].function == NULL || !Init_DD_Worker(&workers[i], set[i].function, set[i].name, partitions[i])) goto fail;
+		created++;
+
+		uint32_t index = releaseCount++;
+		while(index > 0 && releaseTable[index - 1].next > set[i].phase) {
+			releaseTable[index] = releaseTable[index - 1];
+			index--;
 		}
-
-		// Delay the next iteration of the task until the next period
-        timeLeft = this->deadline - curTime;
-        Delete_DD_Task(xTaskGetCurrentTaskHandle(), '1');
-    }
+		releaseTable[index].next = set[i].phase;
+		releaseTable[index].spec = &set[i];
+		releaseTable[index].worker = &workers[i];
+	}
+	vPortFree(partitions);
+	partitions = NULL;
+
+	if(xTaskCreate(DD_Release_Dispatcher, "DD Dispatcher", configMINIMAL_STACK_SIZE, NULL, GENERATOR_DD_PRIORITY, NULL) == pdPASS) return true;
+
+fail:
+	for(uint32_t i = 0; i < created; i++) vTaskDelete(workers[i].handle);
+	vPortFree(partitions);
+	vPortFree(batchWorkers);
+	vPortFree(batchTasks);
+	vPortFree(workers);
+	vPortFree(releaseTable);
+	batchWorkers = NULL;
+	batchTasks = NULL;
+	workers = NULL;
+	releaseTable = NULL;
+	releaseCount = 0;
+	taskSet = NULL;
+	return false;
 }
 
 /*
- * Runs the 2nd periodic task when the scheduler releases it.
+ * Releases every job of the task set into the deadline-driven scheduler from a single task. It sleeps until
+ * the next distinct release instant and submits every job due then as one batch. Release times and deadlines
+ * come from the ideal phase + k * period timeline, so time spent releasing never accumulates.
+ * The job workload is calibrated first and the timeline starts once that is done.
  */
-void PeriodicTask2(void *pvParameters) {
-	bool overdueFlag = false;
-	ddTaskHandle this = (ddTaskHandle)pvParameters;
-	TickType_t curTime, prevTime, timeLeft = 0;
-	TickType_t executionTime = periodicTask2Duration / portTICK_PERIOD_MS;
-
-    while(1) {
-        if(timeLeft != 0) vTaskDelayUntil(&curTime, timeLeft);
-    	// Release the task
-    	curTime = xTaskGetTickCount();
-    	prevTime = curTime;
-    	printf("\nPeriodic Task 2 released at %u ms with priority %u", (unsigned int)curTime, (unsigned int)uxTaskPriorityGet(NULL));
-
-    	// Execute the task for its pre-set duration
-        for(int i = 0; i < executionTime; i++) {
-			if(this->deadline < curTime) {
-				overdueFlag = true;
-				break;
+void DD_Release_Dispatcher(void *pvParameters) {
+	( void ) pvParameters;
+	Calibrate_DD_Workload();
+	printf("\nWorkload calibrated at %u units per tick", (unsigned int)Get_DD_Workload_Rate());
+
+	TickType_t lastWake = xTaskGetTickCount();
+	for(uint32_t i = 0; i < releaseCount; i++) releaseTable[i].next += lastWake;
+
+	while(releaseCount > 0) {
+		if(releaseTable[0].next > lastWake) vTaskDelayUntil(&lastWake, releaseTable[0].next - lastWake);
+		TickType_t curTime = xTaskGetTickCount();
+		uint32_t batchCount = 0;
+
+		while(releaseCount > 0 && releaseTable[0].next <= curTime) {
+			ddRelease_t* row = &releaseTable[0];
+			const ddTaskSpec_t* spec = row->spec;
+
+			// Releases missed while the dispatcher was held off are skipped, not shifted
+			while(spec->period > 0 && row->next + spec->period <= curTime) row->next += spec->period;
+
+			ddTaskHandle newTask = Init_DD_Task();
+			if(newTask != NULL) {
+				newTask->name = spec->name;
+				newTask->number = spec - taskSet;
+				newTask->spec = spec;
+				newTask->type = (spec->period > 0) ? Periodic : Aperiodic;
+				newTask->startTime = row->next;
+				newTask->deadline = Get_DD_Spec_Deadline(spec) + row->next;
+
+				batchTasks[batchCount] = newTask;
+				batchWorkers[batchCount] = row->worker;
+				batchCount++;
+			}
+			// Otherwise the task pool is exhausted and this release is skipped
+
+			if(spec->period == 0) {
+				// An aperiodic row is released once, its worker stays parked at the back of the table
+				row->next = portMAX_DELAY;
+				Sort_DD_Release(0);
+				releaseCount--;
+			} else {
+				row->next += spec->period;
+				Sort_DD_Release(0);
 			}
-        	curTime = xTaskGetTickCount();
-			if( curTime == prevTime ) i--;
-			prevTime = curTime;
-        }
-        curTime = xTaskGetTickCount();
-    	if(overdueFlag == false) {
-			printf("\nPeriodic Task 2 completed at %u ms", (unsigned int)curTime);
-		} else {
-			printf("\nPeriodic Task 2 overdue at %u ms", (unsigned int)curTime);
 		}
 
-        // Delay the next iteration of the task until the next period
-        timeLeft = this->deadline - curTime;
-        //if(timeLeft != 0) vTaskDelayUntil(&curTime, timeLeft);
-        Delete_DD_Task(xTaskGetCurrentTaskHandle(), '2');
-    }
-}
+		// A row is due at most once per pass, so the batch never holds more jobs than the task set
+		if(batchCount > 0) Release_DD_Tasks(batchWorkers, batchTasks, batchCount);
+	}
 
+	vTaskDelete(NULL);
+}
 
 /*
- * Runs the 3rd periodic task when the scheduler releases it.
+ * Runs one job of any task set entry by burning the entry's WCET of CPU time.
  */
-void PeriodicTask3(void *pvParameters) {
+void DD_Task_Body(void *pvParameters) {
 	bool overdueFlag = false;
 	ddTaskHandle this = (ddTaskHandle)pvParameters;
-	TickType_t curTime, prevTime, timeLeft = 0;
-	TickType_t executionTime = periodicTask3Duration / portTICK_PERIOD_MS;
-
-    while(1) {
-        if(timeLeft != 0) vTaskDelayUntil(&curTime, timeLeft);
-    	// Release the task
-    	curTime = xTaskGetTickCount();
-    	prevTime = curTime;
-    	printf("\nPeriodic Task 3 released at %u ms with priority %u", (unsigned int)curTime, (unsigned int)uxTaskPriorityGet( NULL ) );
-
-    	// Execute the task for its pre-set duration
-        for(int i = 0; i < executionTime; i++) {
-        	if(this->deadline < curTime) {
-				overdueFlag = true;
-				break;
-			}
-        	curTime = xTaskGetTickCount();
-			if(curTime == prevTime) i--;
-			prevTime = curTime;
-        }
-        curTime = xTaskGetTickCount();
-    	if(overdueFlag == false) {
-			printf("\nPeriodic Task 3 completed at %u ms", (unsigned int)curTime);
-		} else {
-			printf("\nPeriodic Task 3 overdue at %u ms", (unsigned int)curTime);
+	TickType_t curTime;
+	TickType_t executionTime = (this->spec->wcet * DD_JOB_WORK_PERCENT) / 100;
+
+	// Release the task
+	curTime = xTaskGetTickCount();
+	printf("\n%s released at %u ms with priority %u", this->name, (unsigned int)curTime, (unsigned int)uxTaskPriorityGet( NULL ) );
+
+	// Execute the task for its pre-set duration of CPU time, a tick at a time so a missed deadline is noticed
+	for(TickType_t i = 0; i < executionTime; i++) {
+		if(Get_DD_Hard_Deadline(this) < xTaskGetTickCount()) {
+			overdueFlag = true;
+			break;
 		}
-
-		// Delay the next iteration of the task until the next period
-        timeLeft = this->deadline - curTime;
-        Delete_DD_Task(xTaskGetCurrentTaskHandle(), '3');
-    }
+		Run_DD_Workload(1);
+	}
+	curTime = xTaskGetTickCount();
+	if(overdueFlag == false) {
+		printf("\n%s completed at %u ms", this->name, (unsigned int)curTime);
+	} else {
+		printf("\n%s overdue at %u ms", this->name, (unsigned int)curTime);
+	}
 }
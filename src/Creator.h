@@ -3,23 +3,24 @@
 
 #include <CommonConfig.h>
 #include <Scheduler.h>
+#include <Partition.h>
+#include <Workload.h>
 
-TaskHandle_t PeriodicTaskCreatorHandle1;
-TaskHandle_t PeriodicTaskCreatorHandle2;
-TaskHandle_t PeriodicTaskCreatorHandle3;
-TaskHandle_t AperiodicTaskCreatorHandle;
+// Task set of the selected test bench, indexed by task ID
+extern const ddTaskSpec_t ddTaskSet[];
+extern const uint32_t ddTaskSetSize;
 
-void PeriodicTask1(void *pvParameters);
-void PeriodicTaskCreator1(void *pvParameters);
-void PeriodicTask2(void *pvParameters);
-void PeriodicTaskCreator2(void *pvParameters);
-void PeriodicTask3(void *pvParameters);
-void PeriodicTaskCreator3(void *pvParameters);
+bool Start_DD_TaskSet(const ddTaskSpec_t* set, uint32_t size);
+void DD_Release_Dispatcher(void *pvParameters);
+void DD_Task_Body(void *pvParameters);
 
-void AperiodicTask(void *pvParameters);
-void AperiodicTaskCreator(void *pvParameters);
 
+// Select the test bench at build time, e.g. -DDD_TEST_BENCH=2 for the host simulation
+#ifndef DD_TEST_BENCH
+#define DD_TEST_BENCH				(1)
+#endif
 
+#if DD_TEST_BENCH == 1
 // Test Bench 1
 #define periodicTask1Period 		(500)
 #define periodicTask1Duration   	(95)
@@ -30,7 +31,7 @@ void AperiodicTaskCreator(void *pvParameters);
 #define aperiodicTaskDuration 		(150)
 #define aperiodicTaskDeadline 		(1500)
 
-/*
+#elif DD_TEST_BENCH == 2
 // Test Bench 2
 #define periodicTask1Period 		(250)
 #define periodicTask1Duration   	(95)
@@ -40,8 +41,8 @@ void AperiodicTaskCreator(void *pvParameters);
 #define periodicTask3Duration   	(250)
 #define aperiodicTaskDuration 		(0)
 #define aperiodicTaskDeadline 		(1500)
-*/
-/*
+
+#elif DD_TEST_BENCH == 3
 // Test Bench 3
 #define periodicTask1Period 		(500)
 #define periodicTask1Duration   	(100)
@@ -51,6 +52,14 @@ void AperiodicTaskCreator(void *pvParameters);
 #define periodicTask3Duration   	(200)
 #define aperiodicTaskDuration 		(0)
 #define aperiodicTaskDeadline 		(1500)
-*/
+
+#else
+#error "DD_TEST_BENCH must be 1, 2 or 3"
+#endif
+
+// Percentage of its WCET each bench job actually executes, e.g. -DDD_JOB_WORK_PERCENT=25 leaves slack for the clock governor
+#ifndef DD_JOB_WORK_PERCENT
+#define DD_JOB_WORK_PERCENT			(100)
+#endif
 
 #endif
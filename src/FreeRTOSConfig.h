@@ -83,13 +83,22 @@
  * See http://www.freertos.org/a00110.html.
  *----------------------------------------------------------*/
 
+#ifndef DD_HOST_SIMULATION
 extern uint32_t SystemCoreClock;
 
 
 #define configCPU_CLOCK_HZ                   ( SystemCoreClock )
+#else
+/* Host simulation build (host/Makefile): the POSIX port in
+FreeRTOS_Source/portable/GCC/Posix drives the tick from a host timer every
+configSIM_TICK_PERIOD_US microseconds, so the 1 ms tick the DD tasks are
+written against runs faster than real time. */
+#define configCPU_CLOCK_HZ                   ( ( unsigned long ) 168000000 )
+#define configSIM_TICK_PERIOD_US             ( 100 )
+#endif
 #define configTICK_RATE_HZ                   ( ( TickType_t ) 1000 )
 #define configUSE_MALLOC_FAILED_HOOK         ( 1 )
-#define configUSE_APPLICATION_TASK_TAG       ( 0 )
+#define configUSE_APPLICATION_TASK_TAG       ( 1 )
 #define configUSE_COUNTING_SEMAPHORES        ( 1 )
 #define configUSE_TRACE_FACILITY             ( 1 )
 #define configGENERATE_RUN_TIME_STATS        ( 0 )
@@ -101,13 +110,46 @@ extern uint32_t SystemCoreClock;
 #define configCHECK_FOR_STACK_OVERFLOW       ( 2 )
 #define configUSE_RECURSIVE_MUTEXES          ( 1 )
 #define configMAX_PRIORITIES                 ( 32 )
+#ifndef DD_HOST_SIMULATION
 #define configMINIMAL_STACK_SIZE             ( ( unsigned short ) 130 )
 #define configTOTAL_HEAP_SIZE                ( ( size_t ) ( 60 * 1024 ) )
+#else
+#define configMINIMAL_STACK_SIZE             ( ( unsigned short ) 1024 )
+#define configTOTAL_HEAP_SIZE                ( ( size_t ) ( 4 * 1024 * 1024 ) )
+#endif
 #define configMAX_TASK_NAME_LEN              ( 20 )
 #define configUSE_PREEMPTION                 ( 1 )
-#define configUSE_IDLE_HOOK                  ( 1 )
+#define configUSE_IDLE_HOOK                  ( 0 )
 #define configUSE_TICK_HOOK                  ( 0 )
 
+/* The idle task stops the tick until the next DD release or deadline, see
+vPortSuppressTicksAndSleep() in FreeRTOSHooks.c. The host port cannot suppress
+its tick timer. */
+#ifndef DD_HOST_SIMULATION
+#define configUSE_TICKLESS_IDLE              ( 1 )
+#else
+#define configUSE_TICKLESS_IDLE              ( 0 )
+#endif
+
+/* Set to 1 to order ready lists by absolute deadline in the kernel, in which
+case the DD scheduler sets task deadlines instead of ranking priorities. */
+#define configUSE_EDF_SCHEDULING             ( 0 )
+
+/* Each DD job tags the task running it with its ddTask_t, the switch hooks
+charge the high-resolution counter to the tagged job and count a preemption
+when a job still ready loses the core to another task (see Accounting.c). */
+extern void Switched_In_DD_Task( void *handle, void *tag );
+extern void Switched_Out_DD_Task( void *handle, void *tag, int ready );
+#define traceTASK_SWITCHED_IN()              Switched_In_DD_Task( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag )
+#define traceTASK_SWITCHED_OUT()             Switched_Out_DD_Task( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag, \
+                                                 listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+
+/* The tick interrupt marks where each tick starts on the microsecond time base,
+which is not in phase with SysTick (see Timebase.c). Ticks replayed by
+xTaskResumeAll() are skipped. */
+extern void Mark_DD_Tick( uint32_t tick );
+#define traceTASK_INCREMENT_TICK( xTickCount ) if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( uxPendedTicks == ( UBaseType_t ) 0U ) ) Mark_DD_Tick( ( xTickCount ) + 1 )
+
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                ( 0 )
@@ -129,6 +171,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil              ( 1 )
 #define INCLUDE_vTaskDelay                   ( 1 )
 
+#ifndef DD_HOST_SIMULATION
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
     /* __BVIC_PRIO_BITS will be specified when CMSIS is being used. */
@@ -164,5 +207,12 @@ standard names. */
 #define xPortPendSVHandler PendSV_Handler
 #define xPortSysTickHandler SysTick_Handler
 
+#else
+/* The host port has no interrupt priorities, so a failed assert stops the
+simulation with a message instead of spinning. */
+#define configASSERT( x ) if( ( x ) == 0 ) { vAssertCalled( __FILE__, __LINE__ ); }
+extern void vAssertCalled( const char *pcFile, unsigned long ulLine );
+#endif /* DD_HOST_SIMULATION */
+
 #endif /* FREERTOS_CONFIG_H */
 
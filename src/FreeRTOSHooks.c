@@ -1,4 +1,5 @@
 #include "FreeRTOSHooks.h"
+#include "Creator.h"
 
 /*--------------------------- Application Hooks From Template File --------------------------------*/
 
@@ -30,23 +31,87 @@ void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName
 }
 /*-----------------------------------------------------------*/
 
-void vApplicationIdleHook( void )
+#if ( configUSE_TICKLESS_IDLE == 1 )
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 {
-volatile size_t xFreeStackSpace;
+uint32_t ulCountsPerTick, ulCountsLeft, ulCountsElapsed, ulCompleteTickPeriods, ulSysTickCTRL;
+ddTimeUs_t xSleepStart;
+bool xTickPending;
 
-    /* The idle task hook is enabled by setting configUSE_IDLE_HOOK to 1 in
-    FreeRTOSConfig.h.
+    /* Replaces the weak port implementation. The kernel's expected idle time
+    already ends at the next DD release or deadline, as the dispatcher and the
+    scheduler block until them. The time slept is measured on the free-running
+    microsecond timer, which keeps counting while SysTick is stopped, so no
+    ticks are lost across the sleep. */
+    ulCountsPerTick = SystemCoreClock / configTICK_RATE_HZ;
+    if( xExpectedIdleTime > SysTick_LOAD_RELOAD_Msk / ulCountsPerTick )
+    {
+        xExpectedIdleTime = SysTick_LOAD_RELOAD_Msk / ulCountsPerTick;
+    }
+    if( xExpectedIdleTime < configEXPECTED_IDLE_TIME_BEFORE_SLEEP ) return;
 
-    This function is called on each cycle of the idle task.  In this case it
-    does nothing useful, other than report the amount of FreeRTOS heap that
-    remains unallocated. */
-    xFreeStackSpace = xPortGetFreeHeapSize();
+    __disable_irq();
+    __DSB();
+    __ISB();
 
-    if( xFreeStackSpace > 100 )
+    /* A context switch is pending or a task is waiting for the scheduler to
+    be resumed, so stay awake. */
+    if( eTaskConfirmSleepModeStatus() == eAbortSleep )
     {
-        /* By now, the kernel has allocated everything it is going to, so
-        if there is a lot of heap remaining unallocated then
-        the value of configTOTAL_HEAP_SIZE in FreeRTOSConfig.h can be
-        reduced accordingly. */
+        __enable_irq();
+        return;
     }
+
+    /* Stop SysTick and program it to expire on the tick boundary the sleep
+    should end on, the rest of the current tick period comes first. */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    xSleepStart = Get_DD_Time_Us();
+    ulCountsLeft = SysTick->VAL;
+    SysTick->LOAD = ulCountsLeft + ulCountsPerTick * ( xExpectedIdleTime - 1UL );
+    SysTick->VAL = 0UL;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* Stop SysTick again and work out how far into the tick timeline the
+    sleep got, measured on the microsecond timer. Reading CTRL clears its
+    count flag, so it is read once. */
+    ulSysTickCTRL = SysTick->CTRL;
+    SysTick->CTRL = ulSysTickCTRL & ~SysTick_CTRL_ENABLE_Msk;
+    xTickPending = ( ulSysTickCTRL & SysTick_CTRL_COUNTFLAG_Msk ) != 0;
+    ulCountsElapsed = ( ulCountsPerTick - ulCountsLeft ) + ( Get_DD_Time_Us() - xSleepStart ) * ( ulCountsPerTick / DD_US_PER_TICK );
+    ulCompleteTickPeriods = ulCountsElapsed / ulCountsPerTick;
+    ulCountsLeft = ulCountsPerTick - ( ulCountsElapsed % ulCountsPerTick );
+
+    /* If SysTick reached zero its interrupt is pending and counts one of the
+    elapsed ticks itself once interrupts are enabled again. */
+    if( xTickPending && ulCompleteTickPeriods > 0 ) ulCompleteTickPeriods--;
+    if( ulCompleteTickPeriods > xExpectedIdleTime - 1UL ) ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
+
+    /* Finish the current tick period on time, then go back to normal ticks. */
+    SysTick->LOAD = ulCountsLeft - 1UL;
+    SysTick->VAL = 0UL;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = ulCountsPerTick - 1UL;
+
+    /* The ticks stepped here never ran the tick interrupt, so mark where the
+    current tick started: it ends ulCountsLeft counts from now. A pending
+    SysTick interrupt marks its own tick once interrupts are enabled. */
+    vTaskStepTick( ulCompleteTickPeriods );
+    Mark_DD_Tick_At( xTaskGetTickCount(), Get_DD_Time_Us() + ulCountsLeft / ( ulCountsPerTick / DD_US_PER_TICK ) - DD_US_PER_TICK );
+    __enable_irq();
+}
+/*-----------------------------------------------------------*/
+#endif
+
+#ifdef DD_HOST_SIMULATION
+void vAssertCalled( const char *pcFile, unsigned long ulLine )
+{
+    /* Called by configASSERT() in the host simulation build. Report where the
+    assert failed and stop the run so CI sees a non-zero exit status. */
+    printf( "\nASSERT failed: %s:%lu\n", pcFile, ulLine );
+    exit( 1 );
 }
+#endif
@@ -6,7 +6,12 @@
 
 void vApplicationMallocFailedHook( void );
 void vApplicationStackOverflowHook( xTaskHandle pxTask, signed char *pcTaskName );
-void vApplicationIdleHook( void );
+#if ( configUSE_TICKLESS_IDLE == 1 )
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+#endif
+#ifdef DD_HOST_SIMULATION
+void vAssertCalled( const char *pcFile, unsigned long ulLine );
+#endif
 
 
 #endif /* FREERTOSHOOKS_H_ */
@@ -0,0 +1,202 @@
+/*
+ * 	Governor.c
+ *  Cycle-conserving EDF clock scaling: the core runs at the slowest speed that still covers the worst-case
+ *  demand of jobs not yet finished plus the measured demand of the jobs that finished.
+ */
+
+#include <Governor.h>
+#include <Timebase.h>
+
+// Clock levels from full speed down, the APB dividers keep PCLK1 at a whole number of MHz for the time base
+#ifndef DD_HOST_SIMULATION
+static const ddSpeed_t speeds[DD_SPEED_LEVELS] = {
+	{ .apb1 = RCC_HCLK_Div4, .apb2 = RCC_HCLK_Div2, .divisor = 1, .hclk = RCC_SYSCLK_Div1 },
+	{ .apb1 = RCC_HCLK_Div2, .apb2 = RCC_HCLK_Div1, .divisor = 2, .hclk = RCC_SYSCLK_Div2 },
+	{ .apb1 = RCC_HCLK_Div1, .apb2 = RCC_HCLK_Div1, .divisor = 4, .hclk = RCC_SYSCLK_Div4 },
+	{ .apb1 = RCC_HCLK_Div1, .apb2 = RCC_HCLK_Div1, .divisor = 8, .hclk = RCC_SYSCLK_Div8 },
+};
+#else
+// The host models the levels by divisor only
+static const ddSpeed_t speeds[DD_SPEED_LEVELS] = {
+	{ .divisor = 1 }, { .divisor = 2 }, { .divisor = 4 }, { .divisor = 8 },
+};
+#endif
+
+// Demand of each task ID scaled by DD_UTILISATION_SCALE, worst case from release until the job completes
+static uint32_t demand[DD_GOVERNED_TASKS];
+static uint32_t totalDemand;
+
+// Latest job released for each task ID, only its completion may lower the task's demand
+static ddTaskHandle latestJob[DD_GOVERNED_TASKS];
+
+// Active jobs the governor cannot size, which hold the core at full speed
+static uint32_t unknownJobs;
+
+static uint32_t currentLevel;
+static TickType_t levelSince;
+static TickType_t levelTicks[DD_SPEED_LEVELS];
+
+
+/*
+ * Returns the window a job's demand is spread over, its relative deadline when that is shorter than the period
+ */
+static TickType_t Window_DD_Task(ddTaskHandle task) {
+	TickType_t deadline = task->deadline - task->startTime;
+	return (task->spec->period > 0 && task->spec->period < deadline) ? task->spec->period : deadline;
+}
+
+/*
+ * Replaces the demand of a task ID and keeps the total in step
+ */
+static void Set_DD_Demand(uint32_t id, uint32_t utilisation) {
+	totalDemand = totalDemand - demand[id] + utilisation;
+	demand[id] = utilisation;
+}
+
+/*
+ * Returns true if the governor can size the demand of a job
+ */
+static bool Is_DD_Governed(ddTaskHandle task) {
+	return (task->spec != NULL && task->number < DD_GOVERNED_TASKS && Window_DD_Task(task) > 0);
+}
+
+/*
+ * Raises a task's demand to its worst case as a job is released
+ */
+void Add_DD_Demand(ddTaskHandle task) {
+	if(task == NULL) return;
+
+	// Every scheduler instance shares the demand table
+	taskENTER_CRITICAL();
+	if(!Is_DD_Governed(task)) {
+		unknownJobs++;
+	} else {
+		latestJob[task->number] = task;
+		Set_DD_Demand(task->number, (uint32_t)(((uint64_t)task->spec->wcet * DD_UTILISATION_SCALE + Window_DD_Task(task) - 1) / Window_DD_Task(task)));
+	}
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Lowers a task's demand to what its finished job used, aperiodic tasks have no further demand at all.
+ * Execution is in full-speed cycles, so it is the same work whatever speed the job ran at.
+ */
+static void Settle_DD_Task(ddTaskHandle task) {
+	if(!Is_DD_Governed(task)) {
+		if(unknownJobs > 0) unknownJobs--;
+		return;
+	}
+	if(latestJob[task->number] != task) return;
+	latestJob[task->number] = NULL;
+
+	if(task->spec->period == 0) {
+		Set_DD_Demand(task->number, 0);
+		return;
+	}
+
+	uint64_t window = (uint64_t)Window_DD_Task(task) * DD_US_PER_TICK * DD_CYCLES_PER_US;
+	uint32_t used = (uint32_t)(((uint64_t)task->account.execution * DD_UTILISATION_SCALE + window - 1) / window);
+	if(used < demand[task->number]) Set_DD_Demand(task->number, used);
+}
+
+/*
+ * Settles a finished job's demand, every scheduler instance shares the demand table
+ */
+void Settle_DD_Demand(ddTaskHandle task) {
+	if(task == NULL) return;
+
+	taskENTER_CRITICAL();
+	Settle_DD_Task(task);
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Reprograms the clock tree for a level. Bus dividers go up before HCLK when speeding up and after it when
+ * slowing down so PCLK1 and PCLK2 never exceed their limits, then SysTick and the time base follow the new clock.
+ */
+static void Set_DD_Speed(uint32_t level) {
+	// Settle the host cycle count at the old speed
+	Get_DD_Cycles();
+
+	TickType_t now = xTaskGetTickCount();
+	levelTicks[currentLevel] += now - levelSince;
+	levelSince = now;
+
+#ifndef DD_HOST_SIMULATION
+	const ddSpeed_t* speed = &speeds[level];
+
+	taskENTER_CRITICAL();
+	if(level < currentLevel) {
+		RCC_PCLK1Config(speed->apb1);
+		RCC_PCLK2Config(speed->apb2);
+		RCC_HCLKConfig(speed->hclk);
+	} else {
+		RCC_HCLKConfig(speed->hclk);
+		RCC_PCLK1Config(speed->apb1);
+		RCC_PCLK2Config(speed->apb2);
+	}
+	SystemCoreClockUpdate();
+	SysTick->LOAD = SystemCoreClock / configTICK_RATE_HZ - 1UL;
+	Update_DD_Timebase();
+	currentLevel = level;
+	taskEXIT_CRITICAL();
+#else
+	currentLevel = level;
+#endif
+}
+
+/*
+ * Switches to the slowest level that covers the total demand, called by the scheduler after each pass
+ */
+void Apply_DD_Speed(void) {
+	uint32_t level = 0;
+
+	taskENTER_CRITICAL();
+	// Nothing is known about the load until the first job is released, so the core starts at full speed
+	if(unknownJobs == 0 && totalDemand > 0) {
+		level = DD_SPEED_LEVELS - 1;
+		while(level > 0 && totalDemand > DD_UTILISATION_SCALE / speeds[level].divisor) level--;
+	}
+
+	if(level != currentLevel) Set_DD_Speed(level);
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Returns the core clock in Hz, simulated on the host
+ */
+uint32_t Get_DD_Core_Clock(void) {
+#ifndef DD_HOST_SIMULATION
+	return SystemCoreClock;
+#else
+	return DD_FULL_SPEED_HZ / speeds[currentLevel].divisor;
+#endif
+}
+
+/*
+ * Clears all demand, the core is left at full speed
+ */
+void Init_DD_Governor(void) {
+	memset(demand, 0, sizeof(demand));
+	memset(latestJob, 0, sizeof(latestJob));
+	memset(levelTicks, 0, sizeof(levelTicks));
+	totalDemand = 0;
+	unknownJobs = 0;
+	currentLevel = 0;
+	levelSince = xTaskGetTickCount();
+}
+
+/*
+ * Prints how long the core spent at each clock level
+ */
+void Print_DD_Governor(void) {
+	TickType_t now = xTaskGetTickCount();
+	TickType_t total = (now == 0) ? 1 : now;
+
+	printf("Clock residency:");
+	for(uint32_t level = 0; level < DD_SPEED_LEVELS; level++) {
+		TickType_t ticks = levelTicks[level] + ((level == currentLevel) ? now - levelSince : 0);
+		printf(" %u MHz %u%%", (unsigned int)(DD_FULL_SPEED_HZ / speeds[level].divisor / 1000000UL), (unsigned int)(ticks * 100 / total));
+	}
+	printf("\n");
+}
@@ -0,0 +1,14 @@
+#ifndef GOVERNOR_H_
+#define GOVERNOR_H_
+
+#include <CommonConfig.h>
+#include <Accounting.h>
+
+void Add_DD_Demand(ddTaskHandle task);
+void Apply_DD_Speed(void);
+uint32_t Get_DD_Core_Clock(void);
+void Init_DD_Governor(void);
+void Print_DD_Governor(void);
+void Settle_DD_Demand(ddTaskHandle task);
+
+#endif
@@ -4,46 +4,111 @@
  */
 
 #include <List.h>
+#include <Resource.h>
+
+static ddTask_t taskPool[DD_TASK_POOL_SIZE];
+static ddTaskHandle freeTasks;
+static ddPoolStats_t poolStats;
 
 /*
- * Mallocs/initializes a deadline driven task struct
+ * Threads every pool record onto the free list, must run before the first Init_DD_Task
+ */
+void Init_DD_TaskPool(void) {
+	taskENTER_CRITICAL();
+	freeTasks = NULL;
+	for(uint32_t i = DD_TASK_POOL_SIZE; i > 0; i--) {
+		taskPool[i - 1].next = freeTasks;
+		freeTasks = &taskPool[i - 1];
+	}
+
+	poolStats.capacity = DD_TASK_POOL_SIZE;
+	poolStats.failures = 0;
+	poolStats.highWater = 0;
+	poolStats.inUse = 0;
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Copies the pool counters so callers can detect an undersized pool
+ */
+void Get_DD_TaskPool_Stats(ddPoolStats_t* stats) {
+	if(stats == NULL) return;
+
+	taskENTER_CRITICAL();
+	*stats = poolStats;
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Takes a deadline driven task struct from the pool and initializes it, returns NULL if the pool is empty
  */
 ddTaskHandle Init_DD_Task() {
-	ddTaskHandle newtask = (ddTaskHandle)pvPortMalloc(sizeof(ddTask_t));
+	taskENTER_CRITICAL();
+	ddTaskHandle newtask = freeTasks;
+	if(newtask == NULL) {
+		poolStats.failures++;
+	} else {
+		freeTasks = newtask->next;
+		poolStats.inUse++;
+		if(poolStats.inUse > poolStats.highWater) poolStats.highWater = poolStats.inUse;
+	}
+	taskEXIT_CRITICAL();
+
+	if(newtask == NULL) return NULL;
 
+    memset(&newtask->account, 0, sizeof(ddAccount_t));
     newtask->deadline = 0;
+    newtask->deleting = false;
+    newtask->finished = false;
     newtask->function = NULL;
+    newtask->generation++;
     newtask->handle = NULL;
+    newtask->heapIndex = DD_NOT_IN_HEAP;
     newtask->name = "";
     newtask->number = -1;
+    newtask->overdue = false;
+    newtask->partition = 0;
     newtask->next = NULL;
     newtask->previous = NULL;
+    newtask->requested = portMAX_DELAY;
+    newtask->spec = NULL;
     newtask->startTime = 0;
-    newtask->timer = NULL;
     newtask->type = NoType;
+    newtask->worker = NULL;
 
     return newtask;
 }
 
 /*
- * Zeroes out a deadline-driven task struct and frees the associated memory.
+ * Zeroes out a deadline-driven task struct and returns it to the pool, its deadline timer stays with the record.
  */
 bool Free_DD_Task(ddTaskHandle task) {
-	// Catch bad inputs
+	// Catch bad inputs, including records that did not come from the pool
 	if( task == NULL || task->next != NULL || task->previous != NULL) return false;
+	if( task < &taskPool[0] || task >= &taskPool[DD_TASK_POOL_SIZE]) return false;
 
 	task->deadline = 0;
+    task->deleting = false;
+    task->finished = false;
     task->function = NULL;
 	task->handle = NULL;
+    task->heapIndex = DD_NOT_IN_HEAP;
     task->name = "";
     task->number = -1;
+    task->overdue = false;
+    task->partition = 0;
     task->next = NULL;
     task->previous = NULL;
+    task->spec = NULL;
     task->startTime = 0;
-    task->timer = NULL;
     task->type = NoType;
+    task->worker = NULL;
 
-    vPortFree((void*)task);
+    taskENTER_CRITICAL();
+    task->next = freeTasks;
+    freeTasks = task;
+    poolStats.inUse--;
+    taskEXIT_CRITICAL();
     return true;
 }
 
@@ -60,146 +125,358 @@ void Init_DD_TaskList(ddListHandle list) {
 }
 
 /*
- * Insert a deadline-driven task struct into the overdue or active list
+ * Initialize the heap holding the active deadline-driven tasks
+ */
+void Init_DD_TaskHeap(ddHeapHandle heap) {
+	// Confirm valid pointer
+	if(heap == NULL) return;
+
+	heap->length = 0;
+	heap->nodes = (ddTaskHandle*)pvPortMalloc(DD_INITIAL_HEAP_CAPACITY * sizeof(ddTaskHandle));
+	heap->capacity = (heap->nodes == NULL) ? 0 : DD_INITIAL_HEAP_CAPACITY;
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) heap->running[i] = NULL;
+}
+
+/*
+ * Doubles the heap storage, returns false if the FreeRTOS heap is exhausted
  */
-void Insert_DD_Task(ddTaskHandle task , ddListHandle list) {
+static bool Grow_DD_TaskHeap(ddHeapHandle heap) {
+	uint32_t capacity = (heap->capacity == 0) ? DD_INITIAL_HEAP_CAPACITY : heap->capacity * 2;
+	ddTaskHandle* nodes = (ddTaskHandle*)pvPortMalloc(capacity * sizeof(ddTaskHandle));
+	if(nodes == NULL) return false;
+
+	for(uint32_t i = 0; i < heap->length; i++) nodes[i] = heap->nodes[i];
+	if(heap->nodes != NULL) vPortFree((void*)heap->nodes);
+
+	heap->nodes = nodes;
+	heap->capacity = capacity;
+	return true;
+}
+
+/*
+ * Returns true if task a should run before task b (earliest deadline, with background aperiodic tasks after all periodic ones)
+ */
+static bool Precedes_DD_Task(ddTaskHandle a, ddTaskHandle b) {
+#if ( DD_APERIODIC_SERVER == 0 )
+	if(a->type != b->type) return (b->type == Aperiodic);
+#endif
+	if(a->deadline != b->deadline) return (a->deadline < b->deadline);
+	if(a->account.deadline != b->account.deadline) return ((int32_t)(a->account.deadline - b->account.deadline) < 0);
+	if(a->startTime != b->startTime) return (a->startTime < b->startTime);
+	return (a->number < b->number);
+}
+
+/*
+ * Stores a task at a heap slot and records the slot in the task
+ */
+static void Place_DD_Task(ddHeapHandle heap, uint32_t index, ddTaskHandle task) {
+	heap->nodes[index] = task;
+	task->heapIndex = index;
+}
+
+/*
+ * Moves the task at index towards the root until the heap order holds, returns its final slot
+ */
+static uint32_t SiftUp_DD_Task(ddHeapHandle heap, uint32_t index) {
+	ddTaskHandle task = heap->nodes[index];
+
+	while(index > 0) {
+		uint32_t parent = (index - 1) / 2;
+		if(!Precedes_DD_Task(task, heap->nodes[parent])) break;
+		Place_DD_Task(heap, index, heap->nodes[parent]);
+		index = parent;
+	}
+	Place_DD_Task(heap, index, task);
+	return index;
+}
+
+/*
+ * Moves the task at index away from the root until the heap order holds
+ */
+static void SiftDown_DD_Task(ddHeapHandle heap, uint32_t index) {
+	ddTaskHandle task = heap->nodes[index];
+
+	while(true) {
+		uint32_t child = (2 * index) + 1;
+		if(child >= heap->length) break;
+		if(child + 1 < heap->length && Precedes_DD_Task(heap->nodes[child + 1], heap->nodes[child])) child++;
+		if(!Precedes_DD_Task(heap->nodes[child], task)) break;
+		Place_DD_Task(heap, index, heap->nodes[child]);
+		index = child;
+	}
+	Place_DD_Task(heap, index, task);
+}
+
+/*
+ * Returns the tick a job is overdue after: its deadline, or the earlier one it requested when the aperiodic
+ * server schedules it by a later deadline
+ */
+TickType_t Get_DD_Hard_Deadline(ddTaskHandle task) {
+	return (task->requested < task->deadline) ? task->requested : task->deadline;
+}
+
+/*
+ * Returns a job's preemption level as its relative deadline, a shorter deadline being a higher level
+ */
+TickType_t Get_DD_Preemption_Level(ddTaskHandle task) {
+	return task->deadline - task->startTime;
+}
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+/*
+ * Returns the priority a job runs at under kernel EDF, background aperiodic tasks stay a level below periodic work
+ */
+static UBaseType_t Get_DD_Deadline_Priority(ddTaskHandle task) {
+	return (task->type == Aperiodic && DD_APERIODIC_SERVER == 0) ? BASE_DD_PRIORITY : RUNNING_DD_PRIORITY;
+}
+
+/*
+ * Applies the Stack Resource Policy to the subtree at index: a job due by the top holder's deadline whose level is
+ * not above the system ceiling is parked below the holder, every other job visited gets its deadline priority back.
+ * Subtrees due after the horizon are skipped, returns the number of jobs parked.
+ */
+static uint32_t Park_DD_Tasks(ddHeapHandle heap, uint32_t index, TickType_t horizon, ddTaskHandle holder, ddCeilingHandle ceiling) {
+	ddTaskHandle task = heap->nodes[index];
+	uint32_t parked = 0;
+	if(task->deadline > horizon) return 0;
+
+	if(task != holder) {
+		if(holder != NULL && task->deadline <= holder->deadline && Get_DD_Preemption_Level(task) >= ceiling->system) {
+			vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
+			parked++;
+		} else {
+			vTaskPrioritySet(task->handle, Get_DD_Deadline_Priority(task));
+		}
+	}
+
+	for(uint32_t child = (2 * index) + 1; child <= (2 * index) + 2 && child < heap->length; child++) {
+		parked += Park_DD_Tasks(heap, child, horizon, holder, ceiling);
+	}
+	return parked;
+}
+#else
+/*
+ * Collects the earliest-deadline tasks in rank order by walking the top of the heap, padding with NULL
+ */
+static void Select_DD_Running_Tasks(ddHeapHandle heap, ddTaskHandle* ranked) {
+	uint32_t candidates[DD_RUNNING_SLOTS + 1];
+	uint32_t numCandidates = (heap->length > 0) ? 1 : 0;
+	candidates[0] = 0;
+
+	for(uint32_t rank = 0; rank < DD_RUNNING_SLOTS; rank++) {
+		ranked[rank] = NULL;
+		if(numCandidates == 0) continue;
+
+		// The next rank is the best candidate, whose children then become candidates
+		uint32_t best = 0;
+		for(uint32_t i = 1; i < numCandidates; i++) {
+			if(Precedes_DD_Task(heap->nodes[candidates[i]], heap->nodes[candidates[best]])) best = i;
+		}
+		uint32_t index = candidates[best];
+		ranked[rank] = heap->nodes[index];
+		candidates[best] = candidates[--numCandidates];
+
+		for(uint32_t child = (2 * index) + 1; child <= (2 * index) + 2 && child < heap->length; child++) {
+			if(numCandidates <= DD_RUNNING_SLOTS) candidates[numCandidates++] = child;
+		}
+	}
+}
+
+/*
+ * Applies the Stack Resource Policy to the ranks: jobs ahead of the top resource holder keep their rank only
+ * if their preemption level is above the system ceiling, the others wait behind the holder.
+ */
+static void Apply_DD_Ceiling(ddHeapHandle heap, ddCeilingHandle ceiling, ddTaskHandle* ranked) {
+	ddTaskHandle holder = Get_DD_Ceiling_Holder(ceiling);
+	ddTaskHandle ordered[DD_RUNNING_SLOTS];
+	uint32_t count = 0;
+	uint32_t split = 0;
+
+	ceiling->deferred = false;
+	if(holder == NULL || !Contains_DD_Task(holder, heap)) return;
+
+	// Eligible jobs with earlier deadlines, then the holder, then every other job in deadline order
+	while(split < DD_RUNNING_SLOTS && ranked[split] != NULL && Precedes_DD_Task(ranked[split], holder)) {
+		if(Get_DD_Preemption_Level(ranked[split]) < ceiling->system) ordered[count++] = ranked[split];
+		split++;
+	}
+	if(count < DD_RUNNING_SLOTS) ordered[count++] = holder;
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS && count < DD_RUNNING_SLOTS; i++) {
+		if(ranked[i] == NULL || ranked[i] == holder) continue;
+		if(i < split && Get_DD_Preemption_Level(ranked[i]) < ceiling->system) continue;
+		ordered[count++] = ranked[i];
+	}
+
+	// Unlocking only needs a re-rank if the ceiling changed the order
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) {
+		ddTaskHandle task = (i < count) ? ordered[i] : NULL;
+		if(ranked[i] != task) ceiling->deferred = true;
+		ranked[i] = task;
+	}
+}
+#endif
+
+/*
+ * Re-ranks the running slots, only touching the priority of tasks whose slot changed.
+ * Inserts and removals leave the slots stale, so the scheduler calls this once per batch of commands.
+ */
+void Update_DD_Running_Tasks(ddHeapHandle heap, ddCeilingHandle ceiling) {
+#if ( configUSE_EDF_SCHEDULING == 1 )
+	// The kernel orders ready tasks by deadline itself, only the system ceiling needs priorities. Jobs due after
+	// the top holder never preempt it, so only the ones due by the holder's deadline or parked last time are visited
+	ddTaskHandle holder = Get_DD_Ceiling_Holder(ceiling);
+	if(holder == NULL && ceiling->parked == 0) return;
+
+	TickType_t due = (holder != NULL) ? holder->deadline : 0;
+	TickType_t horizon = (due > ceiling->horizon) ? due : ceiling->horizon;
+	uint32_t parked = (heap->length > 0) ? Park_DD_Tasks(heap, 0, horizon, holder, ceiling) : 0;
+
+	ceiling->deferred = (parked > 0);
+	ceiling->horizon = (parked > 0) ? due : 0;
+	ceiling->parked = parked;
+#else
+	ddTaskHandle ranked[DD_RUNNING_SLOTS];
+	Select_DD_Running_Tasks(heap, ranked);
+	Apply_DD_Ceiling(heap, ceiling, ranked);
+
+	// Park tasks that dropped out of the running slots
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) {
+		ddTaskHandle previous = heap->running[i];
+		bool stillRunning = false;
+		for(uint32_t j = 0; j < DD_RUNNING_SLOTS; j++) {
+			if(ranked[j] == previous) stillRunning = true;
+		}
+		if(previous != NULL && !stillRunning) vTaskPrioritySet(previous->handle, BASE_DD_PRIORITY);
+	}
+
+	// Rank 0 gets the highest running priority
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) {
+		if(ranked[i] != NULL && heap->running[i] != ranked[i]) {
+			vTaskPrioritySet(ranked[i]->handle, RUNNING_DD_PRIORITY + (DD_RUNNING_SLOTS - 1 - i));
+		}
+		heap->running[i] = ranked[i];
+	}
+#endif
+}
+
+/*
+ * Insert a deadline-driven task struct into the active heap, returns false if there is no memory left for it
+ */
+bool Insert_DD_Task(ddTaskHandle task, ddHeapHandle heap) {
 	// Check input parameters are not NULL
-	if(list == NULL || task == NULL) return;
-
-	// First task in the list, insert as the head and the tail
-    if( list->length == 0 ) {
-        list->head = task;
-        list->tail = task;
-        list->length = 1;
-        vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
-        return;
-    }
-
-    ddTaskHandle curTask = list->head;
-    uint32_t curPriority = uxTaskPriorityGet(curTask->handle);
-    curPriority += 1;
-
-    if(curPriority == GENERATOR_DD_PRIORITY) return; // FreeRTOS scheduler is full
-
-    if(task->type == Aperiodic) {
-    	uint32_t tailPriority = uxTaskPriorityGet(list->tail->handle);
-    	vTaskPrioritySet(task->handle, tailPriority);
-    	list->tail->next = task;
-    	list->tail = task;
-    	list->length += 1;
-    	while(curTask->next != NULL) {
-    		vTaskPrioritySet(curTask->handle, curPriority);
-    		curPriority -= 1;
-    		curTask = curTask->next;
-    	}
-    	return;
-    }
-
-    // Iterate through the list starting at the head
-    while(curTask != NULL){
-    	bool equalButSmallerTaskNumber = (task->startTime == curTask->startTime) && (task->deadline == curTask->deadline) && (task->number < curTask->number);
-
-        if(task->deadline < curTask->deadline || curTask->type == Aperiodic || equalButSmallerTaskNumber) {
-        	// Found the location in the list for the task, insert and return
-            if(curTask == list->head){
-            	list->head = task;
-            }
-
-            task->next = curTask;
-            task->previous = curTask->previous;
-            curTask->previous = task;
-
-            list->length += 1;
-            vTaskPrioritySet(task->handle, curPriority);
-            return;
-        } else {
-            if(curTask->next == NULL) {
-            	// At the end of the list, insert the task as the tail and return
-                list->tail = task;
-                task->previous = curTask;
-                task->next = NULL;
-                curTask->next = task;
-
-                list->length += 1;
-                vTaskPrioritySet(curTask->handle, curPriority);
-                vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
-                return;
-            }
-
-            // Iterate to the next task in the list
-            vTaskPrioritySet(curTask->handle, curPriority);
-            curTask = curTask->next;
-            curPriority -= 1;
-        }
-    }
+	if(heap == NULL || task == NULL) return false;
+
+	if(heap->length == heap->capacity && !Grow_DD_TaskHeap(heap)) return false;
+
+	// Add the task as the last leaf and restore the heap order
+	Place_DD_Task(heap, heap->length, task);
+	heap->length += 1;
+	SiftUp_DD_Task(heap, heap->length - 1);
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+	// Hand the deadline to the kernel, background aperiodic tasks stay a level below so periodic work still comes first
+	// A job inserted while a resource is locked is parked next re-rank if its level is not above the system ceiling
+	vTaskDeadlineSet(task->handle, task->deadline);
+	vTaskPrioritySet(task->handle, Get_DD_Deadline_Priority(task));
+#else
+	// Park the task until the next re-rank gives it a running slot
+	vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
+#endif
+	return true;
 }
 
+/*
+ * Returns true if the task is currently held in the active heap
+ */
+bool Contains_DD_Task(ddTaskHandle task, ddHeapHandle heap) {
+	if(task == NULL || heap == NULL) return false;
+	return (task->heapIndex < heap->length && heap->nodes[task->heapIndex] == task);
+}
 
 /*
- * Remove a deadline-driven task from a task list
+ * Remove a deadline-driven task from the active heap, freeing it unless it is being transferred
  */
-void Remove_DD_TaskList(TaskHandle_t task, ddListHandle list, bool transfer, bool trim) {
+void Remove_DD_Task(ddTaskHandle task, ddHeapHandle heap, bool transfer) {
 	// Catch bad inputs
-	if((task == NULL && !trim) || list == NULL || list->length == 0) return;
+	if(!Contains_DD_Task(task, heap)) return;
+
+	uint32_t index = task->heapIndex;
+	bool ranked = false;
+	for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) {
+		if(heap->running[i] == task) {
+			heap->running[i] = NULL;
+			ranked = true;
+		}
+	}
 
-	ddTaskHandle curTask = list->head;
-    uint32_t curPriority = uxTaskPriorityGet(curTask->handle);
+	// A finished or late job drops back to the parked priority, unless a newer job of the same worker already owns it
+	if(task->handle != NULL) {
+#if ( configUSE_EDF_SCHEDULING == 1 )
+		( void ) ranked;
+		if(xTaskDeadlineGet(task->handle) == task->deadline) vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
+#else
+		for(uint32_t i = 0; i < DD_RUNNING_SLOTS; i++) {
+			if(heap->running[i] != NULL && heap->running[i]->handle == task->handle) ranked = false;
+		}
+		if(ranked) vTaskPrioritySet(task->handle, BASE_DD_PRIORITY);
+#endif
+	}
+
+	// Fill the hole with the last leaf and restore the heap order in whichever direction it is broken
+	heap->length -= 1;
+	if(index != heap->length) {
+		Place_DD_Task(heap, index, heap->nodes[heap->length]);
+		if(SiftUp_DD_Task(heap, index) == index) SiftDown_DD_Task(heap, index);
+	}
+	heap->nodes[heap->length] = NULL;
+	task->heapIndex = DD_NOT_IN_HEAP;
 
-    // If the list has only one element that is the task to remove, zero-out the list
-    if(list->length == 1 && (curTask->handle == task || trim)) {
-		list->length = 0;
-    	list->head = NULL;
+	if(!transfer) Free_DD_Task(task);
+}
+
+/*
+ * Remove the head of a deadline-driven task list and free it
+ */
+void Remove_DD_TaskList(ddListHandle list) {
+	// Catch bad inputs
+	if(list == NULL || list->length == 0) return;
+
+	ddTaskHandle curTask = list->head;
+	list->head = curTask->next;
+	if(list->head == NULL) {
 		list->tail = NULL;
-		if(!transfer) Free_DD_Task(curTask);
-		return;
+	} else {
+		list->head->previous = NULL;
 	}
+	(list->length)--;
 
-    // If we're trimming down the size of the overdue list, just remove the head
-    if(trim) {
-    	list->head = curTask->next;
-    	curTask->next->previous = NULL;
-    	(list->length)--;
-    	curTask->previous = NULL;
-    	curTask->next = NULL;
-    	Free_DD_Task(curTask);
-    	return;
-    }
-
-    while(curTask != NULL) {
-        if(curTask->handle == task) {
-
-            // Remove the task from the list (specific cases for head and tail)
-            if(list->tail->handle == task) {
-                list->head = curTask->previous;
-                curTask->previous->next = NULL;
-            } else if(list->head->handle == task) {
-            	list->head = curTask->next;
-            	curTask->next->previous = NULL;
-            } else {
-                curTask->previous->next = curTask->next;
-                curTask->next->previous = curTask->previous;
-            }
-
-            // Decrement the list size and free the task itself
-            list->length -= 1;
-            if(!transfer) Free_DD_Task(curTask);
-            return;
-        } else {
-        	// Iterate to the next task in the list
-			curPriority--;
-			vTaskPrioritySet(curTask->handle, curPriority);
-			curTask = curTask->next;
-        }
-    }
-
-    // Reset all priorities if task not in list
-    curTask = list->tail;
-    curPriority = BASE_DD_PRIORITY;
-    while(curTask != NULL) {
-        vTaskPrioritySet(curTask->handle, curPriority);
-        curTask = curTask->previous;
-        curPriority++;
-    }
+	curTask->previous = NULL;
+	curTask->next = NULL;
+	Free_DD_Task(curTask);
+}
+
+/*
+ * Frees the oldest entries of the overdue list until at most limit are left. A job whose worker is still
+ * running it late, or whose own task is waiting on its DELETE, keeps its record on the list, so the pool
+ * cannot hand it to another release while that task still reads it.
+ */
+void Trim_DD_TaskList(ddListHandle list, uint32_t limit) {
+	if(list == NULL) return;
+
+	ddTaskHandle curTask = list->head;
+	while(curTask != NULL && list->length > limit) {
+		ddTaskHandle next = curTask->next;
+		if((curTask->worker == NULL && !curTask->deleting) || curTask->finished) {
+			if(curTask->previous == NULL) list->head = next; else curTask->previous->next = next;
+			if(next == NULL) list->tail = curTask->previous; else next->previous = curTask->previous;
+			(list->length)--;
+
+			curTask->previous = NULL;
+			curTask->next = NULL;
+			Free_DD_Task(curTask);
+		}
+		curTask = next;
+	}
 }
 
 /*
@@ -220,58 +497,89 @@ void Add_DD_Overdue_TaskList(ddListHandle overdueList, ddTaskHandle curTask) {
 		overdueList->length += 1;
 	}
 
-	// Stop its execution
-	vTaskSuspend(curTask->handle);
-	vTaskDelete(curTask->handle);
+	// Stop its execution, persistent workers finish the late job themselves and stay alive. A task already
+	// deleting its job has finished the body and is left to get its reply and delete itself.
+	if(curTask->worker == NULL && !curTask->deleting) {
+		vTaskSuspend(curTask->handle);
+		vTaskDelete(curTask->handle);
+	}
 }
 
 /*
- * Transfers a task from the active to the overdue list
+ * Moves a task whose deadline has passed from the active heap to the overdue list, returns false if it was not active
  */
-void Transfer_DD_TaskList(ddListHandle activeList, ddListHandle overdueList) {
-	// Confirm valid list
-	if(activeList == NULL || overdueList == NULL) return;
-
-	ddTaskHandle curTask = activeList->head;
-    TickType_t curTicks = xTaskGetTickCount();
-
-    // Iterate through the list and remove overdue tasks from the active list and add to the overdue list
-    while(curTask != NULL) {
-        if(curTicks > 0 && curTask->deadline < (curTicks)) {
-        	Remove_DD_TaskList(curTask->handle, activeList, true, false);
-        	curTask->next = NULL;
-        	Add_DD_Overdue_TaskList(overdueList, curTask);
-        }
-        curTask = curTask->next;
-    }
+bool Transfer_DD_Task(ddTaskHandle task, ddHeapHandle activeHeap, ddListHandle overdueList) {
+	// Confirm valid heap and list
+	if(!Contains_DD_Task(task, activeHeap) || overdueList == NULL) return false;
+
+	Remove_DD_Task(task, activeHeap, true);
+	Add_DD_Overdue_TaskList(overdueList, task);
+	task->overdue = true;
+	return true;
 }
 
-
+/*
+ * Marks an overdue job whose worker finished it, the next trim of the overdue list may then free it
+ */
+void Retire_DD_Task(ddTaskHandle task) {
+	if(task == NULL || !task->overdue) return;
+	task->finished = true;
+}
 
 /*
- * Generates and returns a formatted string of the contents of the input list
+ * Fills the binary record of a job, the release index comes from the job's ideal release time
  */
-char* Get_DD_TaskList(ddListHandle list) {
-	// Malloc and reset the space for the string
-    uint32_t lenList= list->length;
-	char* outputString = (char*)pvPortMalloc(((configMAX_TASK_NAME_LEN + 50) * (lenList + 1)));
-	outputString[0] = '\0';
-
-    if(lenList == 0) {
-    	char emptyString[21] = ("Nothing in list.");
-    	strcat(outputString, emptyString);
-    } else {
-    	// Starting from the head, iterate through the list and append the formatted data to the outputString
-    	ddTaskHandle curTask = list->head;
-		while(curTask != NULL) {
-			char curString[60];
-			uint32_t deadline = (unsigned int) curTask->deadline;
-			sprintf(curString, "Task: %s with deadline: %u \n", curTask->name, deadline);
-			strcat(outputString, curString);
-			curTask = curTask->next;
-		}
-    }
-    return outputString;
+static void Fill_DD_Task_Record(ddTaskRecord_t* record, ddTaskHandle task, ddTaskState_t state, UBaseType_t priority) {
+	const ddTaskSpec_t* spec = task->spec;
+
+	record->deadline = (uint32_t)task->deadline;
+	record->id = task->number;
+	record->number = (spec != NULL && spec->period > 0 && task->startTime >= spec->phase) ? (task->startTime - spec->phase) / spec->period : 0;
+	record->release = (uint32_t)task->startTime;
+	record->priority = (uint8_t)priority;
+	record->state = (uint8_t)state;
+	record->type = (uint8_t)task->type;
+	record->reserved = 0;
 }
 
+/*
+ * Writes one binary record per task of the list into the caller's buffer, returns how many were written
+ */
+uint32_t Get_DD_TaskList(ddListHandle list, ddTaskRecord_t* records, uint32_t capacity) {
+	// Confirm valid pointers
+	if(list == NULL || records == NULL) return 0;
+
+	uint32_t length = 0;
+	for(ddTaskHandle curTask = list->head; curTask != NULL && length < capacity; curTask = curTask->next) {
+		Fill_DD_Task_Record(&records[length++], curTask, Overdue, 0);
+	}
+	return length;
+}
 
+/*
+ * Writes one binary record per task of the active heap into the caller's buffer, earliest deadline first
+ * and the rest in heap order, returns how many were written
+ */
+uint32_t Get_DD_TaskHeap(ddHeapHandle heap, ddTaskRecord_t* records, uint32_t capacity) {
+	// Confirm valid pointers
+	if(heap == NULL || records == NULL) return 0;
+
+	uint32_t length = (heap->length < capacity) ? heap->length : capacity;
+	for(uint32_t i = 0; i < length; i++) {
+		ddTaskHandle curTask = heap->nodes[i];
+#if ( configUSE_EDF_SCHEDULING == 1 )
+		// The kernel runs the earliest deadline, background aperiodic tasks sit a level below the rest
+		Fill_DD_Task_Record(&records[i], curTask, (i == 0) ? Running : Ready, Get_DD_Deadline_Priority(curTask));
+#else
+		ddTaskState_t state = Ready;
+		UBaseType_t priority = BASE_DD_PRIORITY;
+		for(uint32_t rank = 0; rank < DD_RUNNING_SLOTS; rank++) {
+			if(heap->running[rank] != curTask) continue;
+			state = Running;
+			priority = RUNNING_DD_PRIORITY + (DD_RUNNING_SLOTS - 1 - rank);
+		}
+		Fill_DD_Task_Record(&records[i], curTask, state, priority);
+#endif
+	}
+	return length;
+}
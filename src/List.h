@@ -3,13 +3,24 @@
 
 #include <CommonConfig.h>
 
+bool Contains_DD_Task(ddTaskHandle task, ddHeapHandle heap);
 bool Free_DD_Task(ddTaskHandle task);
-char* Get_DD_TaskList(ddListHandle list);
+TickType_t Get_DD_Hard_Deadline(ddTaskHandle task);
+TickType_t Get_DD_Preemption_Level(ddTaskHandle task);
+uint32_t Get_DD_TaskHeap(ddHeapHandle heap, ddTaskRecord_t* records, uint32_t capacity);
+uint32_t Get_DD_TaskList(ddListHandle list, ddTaskRecord_t* records, uint32_t capacity);
 ddTaskHandle Init_DD_Task();
 void Add_DD_Overdue_TaskList(ddListHandle overdueList, ddTaskHandle curTask);
+void Get_DD_TaskPool_Stats(ddPoolStats_t* stats);
+void Init_DD_TaskHeap(ddHeapHandle heap);
+void Init_DD_TaskPool(void);
 void Init_DD_TaskList(ddListHandle list);
-void Insert_DD_Task(ddTaskHandle task , ddListHandle list);
-void Remove_DD_TaskList(TaskHandle_t task, ddListHandle list, bool transfer, bool trim);
-void Transfer_DD_TaskList(ddListHandle activeList, ddListHandle overdueList);
+bool Insert_DD_Task(ddTaskHandle task, ddHeapHandle heap);
+void Remove_DD_Task(ddTaskHandle task, ddHeapHandle heap, bool transfer);
+void Remove_DD_TaskList(ddListHandle list);
+void Retire_DD_Task(ddTaskHandle task);
+void Trim_DD_TaskList(ddListHandle list, uint32_t limit);
+bool Transfer_DD_Task(ddTaskHandle task, ddHeapHandle activeHeap, ddListHandle overdueList);
+void Update_DD_Running_Tasks(ddHeapHandle heap, ddCeilingHandle ceiling);
 
 #endif
@@ -0,0 +1,87 @@
+/*
+ * 	Partition.c
+ *  Splits a task set between the scheduler instances offline, each instance then runs EDF on a core of its own.
+ */
+
+#include <Partition.h>
+
+/*
+ * Density of a periodic task scaled by DD_UTILISATION_SCALE, rounded up. Using min(D, T) keeps each bin
+ * schedulable under EDF by the density test even for constrained deadlines.
+ */
+static uint32_t Density_DD_Spec(const ddTaskSpec_t* spec) {
+	TickType_t deadline = Get_DD_Spec_Deadline(spec);
+	TickType_t window = (deadline != 0 && deadline < spec->period) ? deadline : spec->period;
+	return (uint32_t)(((uint64_t)spec->wcet * DD_UTILISATION_SCALE + window - 1) / window);
+}
+
+/*
+ * Returns the partition with the least load
+ */
+static uint32_t Least_DD_Loaded(const uint32_t* load) {
+	uint32_t best = 0;
+	for(uint32_t i = 1; i < DD_PARTITIONS; i++) {
+		if(load[i] < load[best]) best = i;
+	}
+	return best;
+}
+
+/*
+ * Assigns each entry of a task set to a partition in decreasing order of density, worst-fit or first-fit
+ * by DD_PARTITION_WORST_FIT. Each partition starts with its aperiodic server's reservation, aperiodic
+ * entries go to the least loaded partition. Returns false if some entry fit nowhere, it is then placed
+ * on the least loaded partition and left to that instance's admission test.
+ */
+bool Partition_DD_TaskSet(const ddTaskSpec_t* set, uint32_t size, uint32_t* partitions) {
+	uint32_t load[DD_PARTITIONS];
+	bool fits = true;
+
+	if(set == NULL || partitions == NULL) return false;
+
+	for(uint32_t i = 0; i < DD_PARTITIONS; i++) {
+#if ( DD_APERIODIC_SERVER == 1 )
+		load[i] = (uint32_t)(((uint64_t)DD_SERVER_BUDGET * DD_UTILISATION_SCALE + DD_SERVER_PERIOD - 1) / DD_SERVER_PERIOD);
+#else
+		load[i] = 0;
+#endif
+	}
+	for(uint32_t i = 0; i < size; i++) partitions[i] = DD_PARTITIONS;
+
+	// Periodic entries, largest density first
+	for(uint32_t placed = 0; placed < size; placed++) {
+		uint32_t next = size;
+		uint32_t density = 0;
+
+		for(uint32_t i = 0; i < size; i++) {
+			if(partitions[i] != DD_PARTITIONS || set[i].period == 0) continue;
+			uint32_t candidate = Density_DD_Spec(&set[i]);
+			if(next == size || candidate > density) {
+				next = i;
+				density = candidate;
+			}
+		}
+		if(next == size) break;
+
+#if ( DD_PARTITION_WORST_FIT == 1 )
+		uint32_t target = Least_DD_Loaded(load);
+		if(load[target] + density > DD_UTILISATION_SCALE) target = DD_PARTITIONS;
+#else
+		uint32_t target = 0;
+		while(target < DD_PARTITIONS && load[target] + density > DD_UTILISATION_SCALE) target++;
+#endif
+		if(target == DD_PARTITIONS) {
+			fits = false;
+			target = Least_DD_Loaded(load);
+		}
+
+		partitions[next] = target;
+		load[target] += density;
+	}
+
+	// Aperiodic entries are covered by the server, so they only follow the load
+	for(uint32_t i = 0; i < size; i++) {
+		if(partitions[i] == DD_PARTITIONS) partitions[i] = Least_DD_Loaded(load);
+	}
+
+	return fits;
+}
@@ -0,0 +1,9 @@
+#ifndef PARTITION_H_
+#define PARTITION_H_
+
+#include <CommonConfig.h>
+#include <Admission.h>
+
+bool Partition_DD_TaskSet(const ddTaskSpec_t* set, uint32_t size, uint32_t* partitions);
+
+#endif
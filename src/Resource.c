@@ -0,0 +1,132 @@
+/*
+ * 	Resource.c
+ *  Stack Resource Policy for data shared between deadline-driven jobs. Locking never blocks: a job only starts
+ *  once its preemption level is above the system ceiling, so every resource it can ask for is already free.
+ */
+
+#include <Resource.h>
+
+/*
+ * Clears the locked resources of a scheduler instance
+ */
+void Init_DD_Ceiling(ddCeilingHandle ceiling) {
+	ceiling->deferred = false;
+	ceiling->horizon = 0;
+	ceiling->locked = NULL;
+	ceiling->parked = 0;
+	ceiling->system = portMAX_DELAY;
+}
+
+/*
+ * Initializes a free resource with no users declared yet
+ */
+void Init_DD_Resource(ddResourceHandle resource, const char* name) {
+	if(resource == NULL) return;
+
+	resource->ceiling = portMAX_DELAY;
+	resource->holder = NULL;
+	resource->name = name;
+	resource->owner = NULL;
+	resource->saved = portMAX_DELAY;
+	resource->under = NULL;
+	resource->userCount = 0;
+}
+
+/*
+ * Declares that jobs of a task may lock the resource, raising its ceiling to the task's preemption level.
+ * Every user has to be declared before the task set starts, returns false once the resource is in use or
+ * DD_RESOURCE_USERS tasks are already declared.
+ */
+bool Use_DD_Resource(ddResourceHandle resource, const ddTaskSpec_t* spec) {
+	if(resource == NULL || spec == NULL || resource->owner != NULL) return false;
+
+	TickType_t deadline = Get_DD_Spec_Deadline(spec);
+	if(deadline == 0) return false;
+
+	// Declaring a task twice only counts it once
+	if(!Is_DD_Resource_User(resource, spec)) {
+		if(resource->userCount >= DD_RESOURCE_USERS) return false;
+		resource->users[resource->userCount++] = spec;
+	}
+
+	if(deadline < resource->ceiling) resource->ceiling = deadline;
+	return true;
+}
+
+/*
+ * Returns true if jobs of the task were declared as users of the resource
+ */
+bool Is_DD_Resource_User(ddResourceHandle resource, const ddTaskSpec_t* spec) {
+	if(resource == NULL || spec == NULL) return false;
+
+	for(uint32_t i = 0; i < resource->userCount; i++) {
+		if(resource->users[i] == spec) return true;
+	}
+	return false;
+}
+
+/*
+ * Returns the job holding the most recently locked resource, NULL if nothing is locked
+ */
+ddTaskHandle Get_DD_Ceiling_Holder(ddCeilingHandle ceiling) {
+	ddResourceHandle top = ceiling->locked;
+	return (top != NULL) ? top->holder : NULL;
+}
+
+/*
+ * Locks a resource for a job and raises the system ceiling. Returns false if the job's task was not declared
+ * as a user, the resource is held or belongs to another scheduler instance, all of which break the policy.
+ */
+bool Push_DD_Resource(ddCeilingHandle ceiling, ddResourceHandle resource, ddTaskHandle task) {
+	bool locked = false;
+	if(ceiling == NULL || resource == NULL || task == NULL) return false;
+
+	// The job's own scheduler is the only other code touching this instance's stack
+	taskENTER_CRITICAL();
+	if(resource->holder == NULL && (resource->owner == NULL || resource->owner == ceiling) &&
+			Is_DD_Resource_User(resource, task->spec) && Get_DD_Preemption_Level(task) >= resource->ceiling) {
+		resource->holder = task;
+		resource->owner = ceiling;
+		resource->saved = ceiling->system;
+		resource->under = ceiling->locked;
+		ceiling->locked = resource;
+		if(resource->ceiling < ceiling->system) ceiling->system = resource->ceiling;
+		locked = true;
+	}
+	taskEXIT_CRITICAL();
+
+	return locked;
+}
+
+/*
+ * Unlocks the most recently locked resource and restores the system ceiling from before it was locked.
+ * Returns false unless the job holds the resource on top of the stack, resources unlock in reverse order.
+ */
+bool Pop_DD_Resource(ddCeilingHandle ceiling, ddResourceHandle resource, ddTaskHandle task) {
+	bool unlocked = false;
+	if(ceiling == NULL || resource == NULL) return false;
+
+	taskENTER_CRITICAL();
+	if(ceiling->locked == resource && resource->holder == task) {
+		ceiling->locked = resource->under;
+		ceiling->system = resource->saved;
+		resource->holder = NULL;
+		resource->under = NULL;
+		unlocked = true;
+	}
+	taskEXIT_CRITICAL();
+
+	return unlocked;
+}
+
+/*
+ * Unlocks every resource a finished or deleted job left locked, so its ceiling does not outlive it
+ */
+void Drop_DD_Resources(ddCeilingHandle ceiling, ddTaskHandle task) {
+	if(ceiling == NULL || task == NULL) return;
+
+	while(ceiling->locked != NULL && ceiling->locked->holder == task) {
+		if(!Pop_DD_Resource(ceiling, ceiling->locked, task)) break;
+		ceiling->deferred = true;
+	}
+}
@@ -0,0 +1,17 @@
+#ifndef RESOURCE_H_
+#define RESOURCE_H_
+
+#include <CommonConfig.h>
+#include <List.h>
+#include <Admission.h>
+
+void Drop_DD_Resources(ddCeilingHandle ceiling, ddTaskHandle task);
+ddTaskHandle Get_DD_Ceiling_Holder(ddCeilingHandle ceiling);
+void Init_DD_Ceiling(ddCeilingHandle ceiling);
+void Init_DD_Resource(ddResourceHandle resource, const char* name);
+bool Is_DD_Resource_User(ddResourceHandle resource, const ddTaskSpec_t* spec);
+bool Pop_DD_Resource(ddCeilingHandle ceiling, ddResourceHandle resource, ddTaskHandle task);
+bool Push_DD_Resource(ddCeilingHandle ceiling, ddResourceHandle resource, ddTaskHandle task);
+bool Use_DD_Resource(ddResourceHandle resource, const ddTaskSpec_t* spec);
+
+#endif
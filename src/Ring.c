@@ -0,0 +1,108 @@
+/*
+ * 	Ring.c
+ *  Lock-free multi-producer single-consumer ring carrying commands to the deadline-driven scheduler.
+ *  Producers may be tasks or ISRs and never take a critical section; only the scheduler pops.
+ *  Slots are popped in the order they were reserved, so a producer preempted between reserving and
+ *  publishing holds back later commands until it runs again. It signals the consumer once it publishes.
+ */
+
+#include <Ring.h>
+
+#define DD_RING_MASK		(DD_RING_SIZE - 1)
+
+// Function run between reserving and publishing a slot, the host stress test preempts producers there
+#ifdef DD_RING_RESERVED_HOOK
+void DD_RING_RESERVED_HOOK(void);
+#endif
+
+/*
+ * Initializes an empty ring, slot i starts out free for the producer that reserves position i
+ */
+void Init_DD_Ring(ddRingHandle ring) {
+	// Confirm valid pointer
+	if(ring == NULL) return;
+
+	for(uint32_t i = 0; i < DD_RING_SIZE; i++) ring->slots[i].sequence = i;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->sleeping = 0;
+}
+
+/*
+ * Copies a command into the ring, returns false if the ring is full. wake is set when the consumer
+ * announced it is going to sleep and this producer is the one that has to signal it.
+ */
+bool Push_DD_Ring(ddRingHandle ring, const messageHandle* message, bool* wake) {
+	uint32_t position = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	ddCommandSlot_t* slot;
+	*wake = false;
+
+	// Reserve a position, a slot whose sequence lags the position still holds a command from the last lap
+	while(true) {
+		slot = &ring->slots[position & DD_RING_MASK];
+		int32_t lag = (int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+
+		if(lag == 0) {
+			if(__atomic_compare_exchange_n(&ring->head, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+		} else if(lag < 0) {
+			return false;
+		} else {
+			position = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+		}
+	}
+
+#ifdef DD_RING_RESERVED_HOOK
+	DD_RING_RESERVED_HOOK();
+#endif
+
+	// Publish the command, then check whether the consumer went to sleep before it could see it
+	slot->message = *message;
+	__atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	*wake = (__atomic_exchange_n(&ring->sleeping, 0, __ATOMIC_SEQ_CST) != 0);
+	return true;
+}
+
+/*
+ * Takes the oldest published command, returns false if there is none. Only the consumer may call this.
+ */
+bool Pop_DD_Ring(ddRingHandle ring, messageHandle* message) {
+	ddCommandSlot_t* slot = &ring->slots[ring->tail & DD_RING_MASK];
+	if(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != ring->tail + 1) return false;
+
+	*message = slot->message;
+
+	// Hand the slot back to producers for the next lap
+	__atomic_store_n(&slot->sequence, ring->tail + DD_RING_SIZE, __ATOMIC_RELEASE);
+	ring->tail++;
+	return true;
+}
+
+/*
+ * Returns true if no published command is waiting for the consumer
+ */
+bool Is_DD_Ring_Empty(ddRingHandle ring) {
+	ddCommandSlot_t* slot = &ring->slots[ring->tail & DD_RING_MASK];
+	return (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != ring->tail + 1);
+}
+
+/*
+ * Announces that the consumer is about to block, returns false if a command arrived meanwhile and it should not.
+ * A producer that published before the announcement is seen by the check, one that published after it signals.
+ */
+bool Sleep_DD_Ring(ddRingHandle ring) {
+	__atomic_store_n(&ring->sleeping, 1, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(!Is_DD_Ring_Empty(ring)) {
+		Wake_DD_Ring(ring);
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Clears the consumer's sleep announcement once it is running again
+ */
+void Wake_DD_Ring(ddRingHandle ring) {
+	__atomic_store_n(&ring->sleeping, 0, __ATOMIC_SEQ_CST);
+}
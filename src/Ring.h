@@ -0,0 +1,13 @@
+#ifndef RING_H_
+#define RING_H_
+
+#include <CommonConfig.h>
+
+void Init_DD_Ring(ddRingHandle ring);
+bool Is_DD_Ring_Empty(ddRingHandle ring);
+bool Pop_DD_Ring(ddRingHandle ring, messageHandle* message);
+bool Push_DD_Ring(ddRingHandle ring, const messageHandle* message, bool* wake);
+bool Sleep_DD_Ring(ddRingHandle ring);
+void Wake_DD_Ring(ddRingHandle ring);
+
+#endif
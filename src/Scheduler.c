@@ -5,106 +5,328 @@
 
 #include <Scheduler.h>
 
-static ddList_t activeList;
-static ddList_t overdueList;
+// One scheduler instance per partition of the task set
+static ddScheduler_t schedulers[DD_PARTITIONS];
+// The monitor's copy of a snapshot, which is too large for its stack
+static ddSnapshot_t monitorSnapshot;
 
-static QueueHandle_t xSchedulerMessageQueue;
-static QueueHandle_t xMonitorMessageQueue;
 
+/*
+ * Blocks until one of the given notification bits is set, clears them and returns the bits that were set.
+ * Bits meant for a different wait are left in the notification value for that wait to pick up.
+ */
+static uint32_t Wait_DD_Notification(uint32_t bits) {
+	uint32_t value = 0;
+
+	// Check what is already set before blocking, an earlier wait may have woken on these bits
+	xTaskNotifyWait(0, 0, &value, 0);
+	while((value & bits) == 0) {
+		xTaskNotifyWait(0, 0, &value, portMAX_DELAY);
+	}
+
+	// Clear only the bits consumed here, whether or not another notification is pending
+	xTaskNotifyWait(bits, bits, NULL, 0);
+	return (value & bits);
+}
+
+/*
+ * Notifies the task that sent a command that the scheduler handled it
+ */
+static void Reply_DD_Task(TaskHandle_t sender, bool accepted) {
+	if(sender == NULL) return;
+	xTaskNotify(sender, accepted ? DD_NOTIFY_ACCEPTED : DD_NOTIFY_REJECTED, eSetBits);
+}
+
+/*
+ * Waits for the scheduler to handle a command sent by the calling task, returns false if it was rejected
+ */
+static bool Wait_DD_Reply(void) {
+	return (Wait_DD_Notification(DD_NOTIFY_ACCEPTED | DD_NOTIFY_REJECTED) & DD_NOTIFY_ACCEPTED) != 0;
+}
+
+/*
+ * Queues a command for a scheduler instance from a task, waiting a tick at a time while the ring is full.
+ * The scheduler is only notified if it announced it was going to sleep.
+ */
+static bool Send_DD_Command(ddScheduler_t* scheduler, const messageHandle* message) {
+	bool wake = false;
+	if(scheduler->handle == NULL) return false;
+
+	while(!Push_DD_Ring(&scheduler->commandRing, message, &wake)) vTaskDelay(1);
+	if(wake) xTaskNotifyGive(scheduler->handle);
+	return true;
+}
+
+/*
+ * Queues a command for the scheduler instance of a partition from an ISR, returns false instead of waiting if the ring is full.
+ * pxHigherPriorityTaskWoken is set as for other FromISR calls when the scheduler has to be woken.
+ */
+bool Send_DD_Command_FromISR(uint32_t partition, const messageHandle* message, BaseType_t* pxHigherPriorityTaskWoken) {
+	bool wake = false;
+	if(partition >= DD_PARTITIONS || schedulers[partition].handle == NULL) return false;
+
+	ddScheduler_t* scheduler = &schedulers[partition];
+	if(!Push_DD_Ring(&scheduler->commandRing, message, &wake)) return false;
+	if(wake) vTaskNotifyGiveFromISR(scheduler->handle, pxHigherPriorityTaskWoken);
+	return true;
+}
+
+/*
+ * Returns the scheduler instance a job was assigned to
+ */
+static ddScheduler_t* Get_DD_Scheduler(ddTaskHandle task) {
+	return &schedulers[(task == NULL || task->partition >= DD_PARTITIONS) ? 0 : task->partition];
+}
+
+/*
+ * Arms the wheel event that fires on the first tick past a job's deadline, or past the earlier deadline it
+ * requested when the aperiodic server schedules it by a later one
+ */
+static void Arm_DD_Deadline(ddScheduler_t* scheduler, ddTaskHandle task) {
+	task->timer.expiry = Get_DD_Hard_Deadline(task) + 1;
+	task->timer.owner = (void*)task;
+	Add_DD_Event(&scheduler->eventWheel, &(task->timer));
+}
+
+/*
+ * Drops the deadline event of a job that finished in time
+ */
+static void Disarm_DD_Deadline(ddScheduler_t* scheduler, ddTaskHandle task) {
+	Remove_DD_Event(&scheduler->eventWheel, &(task->timer));
+}
+
+/*
+ * Handles an expired deadline event by moving its job to the overdue list
+ */
+static void Fire_DD_Event(ddScheduler_t* scheduler, ddEventHandle event) {
+	ddTaskHandle task = (ddTaskHandle)event->owner;
+	if(!Transfer_DD_Task(task, &scheduler->activeHeap, &scheduler->overdueList)) return;
+
+	// A job without a worker was deleted and never reports back, so its demand and locks are released here
+	if(task->worker == NULL) {
+		Settle_DD_Demand(task);
+		Drop_DD_Resources(&scheduler->ceiling, task);
+	}
+
+	scheduler->stats.jobsOverdue++;
+	scheduler->snapshotStale = true;
+	Trim_DD_TaskList(&scheduler->overdueList, 5); // Trim down the overdue list if larger than 5
+}
+
+/*
+ * Fires every deadline event that expired up to the current tick
+ */
+static void Expire_DD_Events(ddScheduler_t* scheduler) {
+	ddEventHandle event = Advance_DD_Wheel(&scheduler->eventWheel, xTaskGetTickCount());
+
+	while(event != NULL) {
+		ddEventHandle next = event->next;
+		event->next = NULL;
+		Fire_DD_Event(scheduler, event);
+		event = next;
+	}
+}
 
 /*
- * Accepts scheduling messages and calls scheduling helper functions accordingly.
+ * Admits a new job into the active heap and arms its deadline, returns false if it was rejected
+ */
+static bool Accept_DD_Task(ddScheduler_t* scheduler, ddTaskHandle task) {
+	// The account is opened first, its microsecond deadline breaks ties between deadlines in the same tick
+	Start_DD_Account(task);
+	if(!Admit_DD_Task(&scheduler->admission, task, &scheduler->activeHeap) || !Insert_DD_Task(task, &scheduler->activeHeap)) {
+		scheduler->stats.jobsRejected++;
+		return false;
+	}
+
+	Confirm_DD_Task(&scheduler->admission, task);
+	Arm_DD_Deadline(scheduler, task);
+	Add_DD_Demand(task);
+	scheduler->stats.jobsReleased++;
+
+	// Release jitter is how late the job reached the scheduler after its ideal release time
+	TickType_t releasedAt = xTaskGetTickCount();
+	TickType_t jitter = (releasedAt > task->startTime) ? releasedAt - task->startTime : 0;
+	if(jitter > scheduler->stats.releaseJitterMax) scheduler->stats.releaseJitterMax = jitter;
+	scheduler->stats.releaseJitterTotal += jitter;
+	return true;
+}
+
+/*
+ * Frees a job of a batch that was rejected, deleting its FreeRTOS task unless it belongs to a persistent worker
+ */
+static void Discard_DD_Task(ddTaskHandle task) {
+	if(task->worker == NULL && task->handle != NULL) vTaskDelete(task->handle);
+	Free_DD_Task(task);
+}
+
+/*
+ * Books a job that reported back: its accounting, its share of the frequency demand and any resource it left locked
+ */
+static void Close_DD_Task(ddScheduler_t* scheduler, ddTaskHandle task) {
+	Record_DD_Account(task);
+	Settle_DD_Demand(task);
+	Drop_DD_Resources(&scheduler->ceiling, task);
+}
+
+/*
+ * Applies one scheduling message to the active heap and overdue list, the running slots are re-ranked afterwards
+ */
+static void Handle_DD_Message(ddScheduler_t* scheduler, messageHandle* message) {
+	ddTaskHandle taskHandle = NULL;
+	scheduler->stats.messagesHandled++;
+	scheduler->snapshotStale = true;
+
+	if(xTaskGetTickCount() > DD_RUN_DURATION){
+		Print_DD_Statistics();
+		exit(0);
+	}
+
+	if(message->type == CREATE) {
+		// Admit the deadline driven task and insert it into the active heap, the reply tells the creator if it was accepted
+		taskHandle = (ddTaskHandle)message->data;
+		Reply_DD_Task(message->sender, Accept_DD_Task(scheduler, taskHandle));
+
+	} else if (message->type == CREATE_BATCH) {
+		// Rejected jobs are freed here and cleared from the batch, so the sender only starts the ones left
+		ddBatchHandle batch = (ddBatchHandle)message->data;
+		for(uint32_t i = 0; i < batch->count; i++) {
+			if(batch->tasks[i] == NULL || Accept_DD_Task(scheduler, batch->tasks[i])) continue;
+			Discard_DD_Task(batch->tasks[i]);
+			batch->tasks[i] = NULL;
+		}
+
+		Reply_DD_Task(message->sender, true);
+
+	} else if (message->type == DELETE) {
+		// A job that went overdue while its task was deleting it kept its task and record, the task gets a
+		// rejection and deletes itself. A generation mismatch means the record was reissued, it is left alone.
+		taskHandle = (ddTaskHandle)message->data;
+		if(taskHandle->generation != message->generation || !Contains_DD_Task(taskHandle, &scheduler->activeHeap)) {
+			if(taskHandle->generation == message->generation) {
+				Record_DD_Account(taskHandle);
+				Retire_DD_Task(taskHandle);
+				Trim_DD_TaskList(&scheduler->overdueList, 5);
+			}
+			Reply_DD_Task(message->sender, false);
+			return;
+		}
+
+		// Remove the deadline driven task from the active heap
+		Close_DD_Task(scheduler, taskHandle);
+		Disarm_DD_Deadline(scheduler, taskHandle);
+		Remove_DD_Task(taskHandle, &scheduler->activeHeap, false);
+		scheduler->stats.jobsCompleted++;
+
+		Reply_DD_Task(message->sender, true);
+
+	} else if (message->type == COMPLETE) {
+		// The worker always waits for a reply. A job already on the overdue list kept its record until now,
+		// so the pool never handed it to another release while the worker was still reading it
+		taskHandle = (ddTaskHandle)message->data;
+		if(taskHandle->generation != message->generation) {
+			Reply_DD_Task(message->sender, false);
+			return;
+		}
+
+		if(Contains_DD_Task(taskHandle, &scheduler->activeHeap)) {
+			Close_DD_Task(scheduler, taskHandle);
+			Disarm_DD_Deadline(scheduler, taskHandle);
+			Remove_DD_Task(taskHandle, &scheduler->activeHeap, false);
+			scheduler->stats.jobsCompleted++;
+		} else if(taskHandle->overdue && !taskHandle->finished) {
+			Close_DD_Task(scheduler, taskHandle);
+			Retire_DD_Task(taskHandle);
+			Trim_DD_TaskList(&scheduler->overdueList, 5);
+		}
+
+		Reply_DD_Task(message->sender, true);
+
+	} else if (message->type == UNLOCK) {
+		// The system ceiling already dropped, the re-rank after this batch lets the jobs held back run
+	}
+}
+
+/*
+ * Rewrites the snapshot of both lists, readers that overlap the rewrite see the sequence move and copy again
+ */
+static void Publish_DD_Snapshot(ddScheduler_t* scheduler) {
+	ddSnapshot_t* snapshot = &scheduler->snapshot;
+
+	__atomic_store_n(&snapshot->sequence, snapshot->sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	snapshot->activeLength = Get_DD_TaskHeap(&scheduler->activeHeap, snapshot->active, DD_SNAPSHOT_ACTIVE);
+	snapshot->overdueLength = Get_DD_TaskList(&scheduler->overdueList, snapshot->overdue, DD_SNAPSHOT_OVERDUE);
+	snapshot->time = xTaskGetTickCount();
+
+	__atomic_store_n(&snapshot->sequence, snapshot->sequence + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Accepts scheduling messages for one scheduler instance and calls scheduling helper functions accordingly.
  */
 void DD_Scheduler(void *pvParameters) {
+	ddScheduler_t* scheduler = (ddScheduler_t*)pvParameters;
 	messageHandle message;
-    ddTaskHandle taskHandle = NULL;
 
     while(1) {
-        if(xQueueReceive(xSchedulerMessageQueue, (void*)&message, portMAX_DELAY) == pdTRUE) {
-            Transfer_DD_TaskList(&activeList, &overdueList); // Transfer any overdue tasks to the overdue list
-            while(overdueList.length > 5) Remove_DD_TaskList(NULL, &overdueList, false, true); // Trim down the overdue list if larger than 5
-
-            if(xTaskGetTickCount() > 1500){
-            	exit(0);
-            }
-
-			if(message.type == CREATE) {
-				// Insert the deadline driven task into the active list
-				taskHandle = (ddTaskHandle)message.data;
-				Insert_DD_Task(taskHandle, &activeList);
-
-				uint16_t flag = 1;
-				char name[32] = "";
-				strcat(name, taskHandle->name);
-				if (name[14] == '1') {
-					xQueueOverwrite(xTask1Queue, &flag);
-				} else if(name[14] == '2'){
-					xQueueOverwrite(xTask2Queue, &flag);
-				} else if(name[14] == '3'){
-					xQueueOverwrite(xTask3Queue, &flag);
-				} else {
-					xQueueOverwrite(xTaskAperiodicQueue, &flag);
-				}
-
-			} else if (message.type == DELETE) {
-				// Remove the deadline driven task from its list
-				Remove_DD_TaskList(message.sender, &activeList, false, false);
-
-				uint16_t flag = 1;
-				char name[32] = "";
-				strcat(name, taskHandle->name);
-				if (name[14] == '1') {
-					xQueueOverwrite(xTask1Queue, &flag);
-				} else if(name[14] == '2'){
-					xQueueOverwrite(xTask2Queue, &flag);
-				} else if(name[14] == '3'){
-					xQueueOverwrite(xTask3Queue, &flag);
-				} else {
-					xQueueOverwrite(xTaskAperiodicQueue, &flag);
-				}
-
-			} else if (message.type == ACTIVE_LIST) {
-				// Get the active list
-				message.data = (void*)Get_DD_TaskList(&activeList);
-
-				// Clear the monitor queue if full
-				if(uxQueueSpacesAvailable(xMonitorMessageQueue) == 0) xQueueReset(xMonitorMessageQueue);
-
-				// Send data to monitor queue
-				if( xMonitorMessageQueue == NULL) return;
-				if( xQueueSend( xMonitorMessageQueue, &message, (TickType_t) portMAX_DELAY ) != pdPASS ) return;
-
-			} else if (message.type == OVERDUE_LIST) {
-				// Get the overdue list
-				message.data = (void*)Get_DD_TaskList(&overdueList);
-
-				// Clear the monitor queue if full
-				if(uxQueueSpacesAvailable(xMonitorMessageQueue) == 0) xQueueReset(xMonitorMessageQueue);
-
-				// Send data to monitor queue
-				if(xMonitorMessageQueue == NULL) return;
-				if(xQueueSend( xMonitorMessageQueue, &message, (TickType_t) portMAX_DELAY ) != pdPASS) return;
-
-			}
-        }
+    	// Apply every pending command and expired deadline, then re-rank the running slots once for the whole batch
+    	while(Pop_DD_Ring(&scheduler->commandRing, &message)) Handle_DD_Message(scheduler, &message);
+    	Expire_DD_Events(scheduler);
+    	Update_DD_Running_Tasks(&scheduler->activeHeap, &scheduler->ceiling);
+    	Apply_DD_Speed();
+
+    	if(scheduler->snapshotStale) {
+    		Publish_DD_Snapshot(scheduler);
+    		scheduler->snapshotStale = false;
+    	}
+
+    	// Sleep until the next command or the next deadline, whichever comes first
+    	TickType_t nextEvent = Next_DD_Event(&scheduler->eventWheel);
+    	TickType_t curTime = xTaskGetTickCount();
+    	TickType_t timeout = (nextEvent == portMAX_DELAY) ? portMAX_DELAY : ((nextEvent > curTime) ? nextEvent - curTime : 0);
+
+        // A command pushed after the announcement notifies this task, one pushed before it cancels the sleep
+        if(!Sleep_DD_Ring(&scheduler->commandRing)) continue;
+        ulTaskNotifyTake(pdTRUE, timeout);
+        Wake_DD_Ring(&scheduler->commandRing);
     }
 }
 
 /*
- * Initializes the active and overdue lists and corresponding tasks/queues
+ * Initializes the lists, admission state and command ring of a scheduler instance and starts its task
  */
-void DD_Scheduler_Init() {
-    Init_DD_TaskList(&overdueList);
-    Init_DD_TaskList(&activeList);
-
-    // Assign highest priority to inter-task communications
-    xSchedulerMessageQueue = xQueueCreate(MAX_DD_TASK_PRIORITY, sizeof(messageHandle));
-    vQueueAddToRegistry(xSchedulerMessageQueue,"Scheduler Queue");
+static void Init_DD_Scheduler(ddScheduler_t* scheduler, uint32_t partition) {
+	char name[configMAX_TASK_NAME_LEN];
+
+	Init_DD_TaskList(&scheduler->overdueList);
+	Init_DD_TaskHeap(&scheduler->activeHeap);
+	Init_DD_Wheel(&scheduler->eventWheel, xTaskGetTickCount());
+	Init_DD_Admission(&scheduler->admission);
+	Init_DD_Ceiling(&scheduler->ceiling);
+	Init_DD_Ring(&scheduler->commandRing);
+
+	scheduler->handle = NULL;
+	scheduler->partition = partition;
+	memset(&scheduler->snapshot, 0, sizeof(ddSnapshot_t));
+	scheduler->snapshotStale = false;
+	memset(&scheduler->stats, 0, sizeof(ddSchedulerStats_t));
+
+	// Assign highest priority to inter-task communications
+	sprintf(name, "DD Scheduler %u", (unsigned int)partition);
+	xTaskCreate(DD_Scheduler, name, configMINIMAL_STACK_SIZE, (void*)scheduler, SCHEDULER_DD_PRIORITY, &scheduler->handle);
+}
 
-    xMonitorMessageQueue = xQueueCreate(2, sizeof(messageHandle));
-    vQueueAddToRegistry(xMonitorMessageQueue,"Monitor Queue");
+/*
+ * Initializes every scheduler instance and the state they share
+ */
+void DD_Scheduler_Init() {
+    Init_DD_TaskPool();
+    Init_DD_Timebase();
+    Init_DD_Governor();
+    Init_DD_Accounting();
 
-    xTaskCreate(DD_Scheduler , "DD Scheduler Task" 	, configMINIMAL_STACK_SIZE , NULL , SCHEDULER_DD_PRIORITY , NULL);
+    for(uint32_t i = 0; i < DD_PARTITIONS; i++) Init_DD_Scheduler(&schedulers[i], i);
     xTaskCreate(Monitor		 , "Monitor Task"   	, configMINIMAL_STACK_SIZE , NULL , MONITOR_DD_PRIORITY   , NULL);
 
 }
@@ -127,60 +349,317 @@ void Create_DD_Task(ddTaskHandle task) {
 
     // Suspend the task until it was been added to the deadline driven scheduler
     vTaskSuspend(task->handle);
+    vTaskSetApplicationTaskTag(task->handle, (TaskHookFunction_t)task);
 
-    messageHandle message = {CREATE, xTaskGetCurrentTaskHandle(), task};
+    messageHandle message = {CREATE, xTaskGetCurrentTaskHandle(), task, 0};
 
-    if(xSchedulerMessageQueue == NULL) return;
-    if(xQueueSend(xSchedulerMessageQueue, &message, portMAX_DELAY) != pdPASS) return;
+    if(!Send_DD_Command(Get_DD_Scheduler(task), &message)) return;
 
     // Resume the task once it's been added to the deadline driven scheduler
-    uint16_t flag = 0;
-	char name[32] = "";
-	strcat(name, task->name);
-	if (name[14] == '1') {
-		xQueueReceive(xTask1Queue, &flag, portMAX_DELAY);
-	} else if(name[14] == '2'){
-		xQueueReceive(xTask2Queue, &flag, portMAX_DELAY);
-	} else if(name[14] == '3'){
-		xQueueReceive(xTask3Queue, &flag, portMAX_DELAY);
-	} else {
-		xQueueReceive(xTaskAperiodicQueue, &flag, portMAX_DELAY);
+	bool accepted = Wait_DD_Reply();
+
+	// The scheduler had no room for the task, so it never runs
+	if(!accepted) {
+		vTaskDelete(task->handle);
+		task->handle = NULL;
+		Free_DD_Task(task);
+		return;
 	}
+
     vTaskResume(task->handle);
     return;
 }
 
+/*
+ * Orders a batch by partition so each scheduler instance gets one contiguous run, workers move with their jobs
+ */
+static void Group_DD_Batch(ddTaskHandle* tasks, ddWorkerHandle* workers, uint32_t count) {
+	for(uint32_t i = 1; i < count; i++) {
+		ddTaskHandle task = tasks[i];
+		ddWorkerHandle worker = (workers != NULL) ? workers[i] : NULL;
+		ddScheduler_t* scheduler = Get_DD_Scheduler(task);
+
+		uint32_t j = i;
+		while(j > 0 && Get_DD_Scheduler(tasks[j - 1]) > scheduler) {
+			tasks[j] = tasks[j - 1];
+			if(workers != NULL) workers[j] = workers[j - 1];
+			j--;
+		}
+		tasks[j] = task;
+		if(workers != NULL) workers[j] = worker;
+	}
+}
+
+/*
+ * Sends each run of a grouped batch to its scheduler instance as one message and waits for the reply,
+ * returns false if a scheduler is not running
+ */
+static bool Submit_DD_Batch(ddTaskHandle* tasks, uint32_t count) {
+	uint32_t start = 0;
+
+	while(start < count) {
+		ddScheduler_t* scheduler = Get_DD_Scheduler(tasks[start]);
+		uint32_t end = start + 1;
+		while(end < count && Get_DD_Scheduler(tasks[end]) == scheduler) end++;
+
+		ddBatch_t batch = {end - start, &tasks[start]};
+		messageHandle message = {CREATE_BATCH, xTaskGetCurrentTaskHandle(), &batch, 0};
+
+		if(!Send_DD_Command(scheduler, &message)) return false;
+		Wait_DD_Reply();
+		start = end;
+	}
+	return true;
+}
+
+/*
+ * Creates several deadline-driven tasks as FreeRTOS tasks and submits them to their schedulers, one message per instance.
+ * Rejected tasks are deleted and their entries set to NULL, the array is reordered by partition.
+ */
+void Create_DD_Tasks(ddTaskHandle* tasks, uint32_t count) {
+	if(tasks == NULL || count == 0) return;
+
+	for(uint32_t i = 0; i < count; i++) {
+		if(tasks[i] == NULL) continue;
+		xTaskCreate(tasks[i]->function, tasks[i]->name, configMINIMAL_STACK_SIZE, (void*)tasks[i], MIN_DD_PRIORITY, &(tasks[i]->handle));
+
+		// Tasks stay suspended until the scheduler has seen the whole batch
+		if(tasks[i]->handle == NULL) {
+			Free_DD_Task(tasks[i]);
+			tasks[i] = NULL;
+		} else {
+			vTaskSuspend(tasks[i]->handle);
+			vTaskSetApplicationTaskTag(tasks[i]->handle, (TaskHookFunction_t)tasks[i]);
+		}
+	}
+
+	Group_DD_Batch(tasks, NULL, count);
+	if(!Submit_DD_Batch(tasks, count)) return;
+
+	for(uint32_t i = 0; i < count; i++) {
+		if(tasks[i] != NULL) vTaskResume(tasks[i]->handle);
+	}
+}
+
 /*
  * Sends a delete command to deadline-driven scheduler and then deletes the FreeRTOS task
  */
-void Delete_DD_Task(TaskHandle_t task, char number) {
+void Delete_DD_Task(ddTaskHandle task) {
     if(task == NULL) return;
 
-    messageHandle task_message = {DELETE, task, NULL};
+    // The scheduler frees the task struct, so keep what is needed after the reply. Once the job is marked
+    // as deleting, its deadline passing no longer deletes this task before it has the reply.
+    TaskHandle_t handle = task->handle;
+    task->deleting = true;
+    Stop_DD_Account(task);
 
-    // Send the message to the scheduler queue
-    if(xSchedulerMessageQueue == NULL) return;
-	if(xQueueSend(xSchedulerMessageQueue, &task_message, portMAX_DELAY) != pdPASS) return;
+    messageHandle task_message = {DELETE, handle, task, task->generation};
 
-	uint16_t flag = 0;
-	if(number == '1') {
-		xQueueReceive(xTask1Queue, &flag, portMAX_DELAY);
-	} else if(number == '2'){
-		xQueueReceive(xTask2Queue, &flag, portMAX_DELAY);
-	} else if(number == '3'){
-		xQueueReceive(xTask3Queue, &flag, portMAX_DELAY);
-	} else {
-		xQueueReceive(xTaskAperiodicQueue, &flag, portMAX_DELAY);
-	}
+    // Send the message to the scheduler command ring
+    if(!Send_DD_Command(Get_DD_Scheduler(task), &task_message)) return;
 
-    vTaskDelete(task);
+	Wait_DD_Reply();
+
+    vTaskDelete(handle);
     return;
 }
 
+/*
+ * Runs the jobs released to a persistent worker, blocking between releases
+ */
+static void DD_Worker(void *pvParameters) {
+	ddWorkerHandle worker = (ddWorkerHandle)pvParameters;
+
+	while(1) {
+		// A release that arrives while a job is still running is picked up straight after it
+		Wait_DD_Notification(DD_NOTIFY_RELEASE);
+		ddTaskHandle job = __atomic_exchange_n(&worker->job, NULL, __ATOMIC_ACQ_REL);
+		if(job == NULL) continue;
+
+		Begin_DD_Account(job);
+		worker->function((void*)job);
+		Stop_DD_Account(job);
+		Complete_DD_Task(job);
+	}
+}
+
+/*
+ * Creates the FreeRTOS task that runs every job of one periodic deadline-driven task, its jobs go to the scheduler of the partition
+ */
+bool Init_DD_Worker(ddWorkerHandle worker, TaskFunction_t function, const char* name, uint32_t partition) {
+	if(worker == NULL || function == NULL || partition >= DD_PARTITIONS) return false;
+
+	worker->function = function;
+	worker->job = NULL;
+	worker->name = name;
+	worker->partition = partition;
+	worker->handle = NULL;
+
+	xTaskCreate(DD_Worker,
+				name,
+				configMINIMAL_STACK_SIZE,
+				(void*)worker,
+				MIN_DD_PRIORITY,
+				&(worker->handle));
+
+	return (worker->handle != NULL);
+}
+
+/*
+ * Hands an accepted job to its worker. A job the worker never picked up is superseded and will never run,
+ * so it is marked finished for the overdue list to free once its deadline has passed.
+ */
+static void Hand_DD_Job(ddWorkerHandle worker, ddTaskHandle task) {
+	ddTaskHandle superseded = __atomic_exchange_n(&worker->job, task, __ATOMIC_ACQ_REL);
+	if(superseded != NULL) superseded->finished = true;
+	xTaskNotify(worker->handle, DD_NOTIFY_RELEASE, eSetBits);
+}
+
+/*
+ * Adds a job to the deadline-driven scheduler and hands it to its persistent worker
+ */
+void Release_DD_Task(ddWorkerHandle worker, ddTaskHandle task) {
+	if(worker == NULL || worker->handle == NULL || task == NULL) return;
+
+	task->function = worker->function;
+	task->handle = worker->handle;
+	task->partition = worker->partition;
+	task->worker = worker;
+
+	messageHandle message = {CREATE, xTaskGetCurrentTaskHandle(), task, 0};
+
+	if(!Send_DD_Command(Get_DD_Scheduler(task), &message)) return;
+
+	bool accepted = Wait_DD_Reply();
+
+	// The scheduler had no room for the job, so it is never run
+	if(!accepted) {
+		task->handle = NULL;
+		task->worker = NULL;
+		Free_DD_Task(task);
+		return;
+	}
+
+	Hand_DD_Job(worker, task);
+}
+
+/*
+ * Adds jobs released at the same instant to the deadline-driven scheduler in one message, each job
+ * going to the worker at the same index. Rejected jobs are freed and their entries set to NULL.
+ */
+void Release_DD_Tasks(ddWorkerHandle* workers, ddTaskHandle* tasks, uint32_t count) {
+	if(workers == NULL || tasks == NULL || count == 0) return;
+
+	for(uint32_t i = 0; i < count; i++) {
+		if(tasks[i] == NULL) continue;
+		if(workers[i] == NULL || workers[i]->handle == NULL) {
+			Free_DD_Task(tasks[i]);
+			tasks[i] = NULL;
+			continue;
+		}
+
+		tasks[i]->function = workers[i]->function;
+		tasks[i]->handle = workers[i]->handle;
+		tasks[i]->partition = workers[i]->partition;
+		tasks[i]->worker = workers[i];
+	}
+
+	Group_DD_Batch(tasks, workers, count);
+	if(!Submit_DD_Batch(tasks, count)) return;
+
+	for(uint32_t i = 0; i < count; i++) {
+		if(tasks[i] == NULL) continue;
+		Hand_DD_Job(workers[i], tasks[i]);
+	}
+}
+
+/*
+ * Tells the deadline-driven scheduler a worker finished its job, the worker itself keeps running
+ */
+void Complete_DD_Task(ddTaskHandle task) {
+	if(task == NULL) return;
+
+	messageHandle message = {COMPLETE, xTaskGetCurrentTaskHandle(), task, task->generation};
+
+	if(!Send_DD_Command(Get_DD_Scheduler(task), &message)) return;
+
+	Wait_DD_Reply();
+}
+
+/*
+ * Locks a shared resource for the calling job under the Stack Resource Policy, the job never blocks here.
+ * Returns false if the job's task was not declared with Use_DD_Resource or the resource is in another partition.
+ */
+bool Lock_DD_Resource(ddResourceHandle resource, ddTaskHandle task) {
+	if(task == NULL) return false;
+	return Push_DD_Resource(&Get_DD_Scheduler(task)->ceiling, resource, task);
+}
+
+/*
+ * Unlocks the resource the calling job locked last, waking the scheduler only if the ceiling held a job back
+ */
+bool Unlock_DD_Resource(ddResourceHandle resource, ddTaskHandle task) {
+	if(task == NULL) return false;
+
+	ddScheduler_t* scheduler = Get_DD_Scheduler(task);
+	if(!Pop_DD_Resource(&scheduler->ceiling, resource, task)) return false;
+
+	if(scheduler->ceiling.deferred) {
+		messageHandle message = {UNLOCK, xTaskGetCurrentTaskHandle(), resource, 0};
+		Send_DD_Command(scheduler, &message);
+	}
+	return true;
+}
+
+/*
+ * Prints the run counters used to benchmark the scheduler
+ */
+void Print_DD_Statistics(void) {
+	ddSchedulerStats_t total;
+	memset(&total, 0, sizeof(ddSchedulerStats_t));
+
+	// Totals over every scheduler instance
+	for(uint32_t i = 0; i < DD_PARTITIONS; i++) {
+		const ddSchedulerStats_t* stats = &schedulers[i].stats;
+		total.jobsCompleted += stats->jobsCompleted;
+		total.jobsOverdue += stats->jobsOverdue;
+		total.jobsRejected += stats->jobsRejected;
+		total.jobsReleased += stats->jobsReleased;
+		total.messagesHandled += stats->messagesHandled;
+		total.releaseJitterTotal += stats->releaseJitterTotal;
+		if(stats->releaseJitterMax > total.releaseJitterMax) total.releaseJitterMax = stats->releaseJitterMax;
+	}
+	uint32_t missRate = (total.jobsReleased == 0) ? 0 : (total.jobsOverdue * 100) / total.jobsReleased;
+
+	printf("\n\nDD statistics after %u ms:\n", (unsigned int)xTaskGetTickCount());
+	printf("Messages handled: %u\n", (unsigned int)total.messagesHandled);
+	printf("Jobs released: %u, completed: %u, overdue: %u (%u%%), rejected: %u\n",
+			(unsigned int)total.jobsReleased, (unsigned int)total.jobsCompleted, (unsigned int)total.jobsOverdue,
+			(unsigned int)missRate, (unsigned int)total.jobsRejected);
+	printf("Release jitter: max %u, mean %u ticks\n", (unsigned int)total.releaseJitterMax,
+			(unsigned int)((total.jobsReleased == 0) ? 0 : total.releaseJitterTotal / total.jobsReleased));
+
+	for(uint32_t i = 0; i < DD_PARTITIONS; i++) {
+		ddScheduler_t* scheduler = &schedulers[i];
+		printf("Partition %u: admitted periodic tasks: %u, utilisation %u%%, released %u, overdue %u, rejected %u\n",
+				(unsigned int)i, (unsigned int)Get_DD_Admitted_Tasks(&scheduler->admission),
+				(unsigned int)Get_DD_Utilisation(&scheduler->admission), (unsigned int)scheduler->stats.jobsReleased,
+				(unsigned int)scheduler->stats.jobsOverdue, (unsigned int)scheduler->stats.jobsRejected);
+	}
+
+	ddPoolStats_t pool;
+	Get_DD_TaskPool_Stats(&pool);
+	printf("Task pool: %u of %u in use, high water %u, failed acquires %u\n",
+			(unsigned int)pool.inUse, (unsigned int)pool.capacity, (unsigned int)pool.highWater, (unsigned int)pool.failures);
+	Print_DD_Accounting();
+	Print_DD_Governor();
+}
+
 /*
  * Task that calls the active/overdue list printers every 500ms
  */
 void Monitor(void *pvParameters) {
+	( void ) pvParameters;
 
 	uint32_t delay = 10;
 	uint32_t totalDelay = 0;
@@ -195,43 +674,59 @@ void Monitor(void *pvParameters) {
 }
 
 /*
- * Prints the contents of the active task list
+ * Copies the latest snapshot of both lists of one partition without blocking or entering its scheduler,
+ * retrying only if a publish overlapped the copy
  */
-void Get_Active_DD_TaskList(uint32_t totalDelay) {
-	messageHandle activeMessage = {ACTIVE_LIST, NULL, NULL};
-
-	// Send Message to scheduler queue
-	if(xSchedulerMessageQueue == NULL) return;
-	if(xQueueSend(xSchedulerMessageQueue, &activeMessage, (TickType_t)portMAX_DELAY ) != pdPASS) return;
+void Read_DD_Snapshot(uint32_t partition, ddSnapshot_t* copy) {
+	uint32_t before, after;
+	if(copy == NULL || partition >= DD_PARTITIONS) return;
+
+	ddSnapshot_t* snapshot = &schedulers[partition].snapshot;
+	do {
+		before = __atomic_load_n(&snapshot->sequence, __ATOMIC_ACQUIRE);
+		memcpy(copy, snapshot, sizeof(ddSnapshot_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = __atomic_load_n(&snapshot->sequence, __ATOMIC_RELAXED);
+	} while((before & 1) != 0 || before != after);
+}
 
-	// Wait for the response data from the monitor queue
-	if(xMonitorMessageQueue == NULL) return;
-	if(xQueueReceive( xMonitorMessageQueue, &activeMessage, (TickType_t) portMAX_DELAY) == pdTRUE) {
-		printf("\n\nActive Tasks at %u: \n%s\n", (unsigned int)totalDelay, (char*)(activeMessage.data));
-		vPortFree(activeMessage.data);
-		activeMessage.data = NULL;
+/*
+ * Decodes and prints the binary records of one snapshot list
+ */
+static void Print_DD_Task_Records(const ddTaskRecord_t* records, uint32_t length) {
+	static const char* const states[] = {"ready", "running", "overdue"};
+
+	if(length == 0) printf("Nothing in list.");
+	for(uint32_t i = 0; i < length; i++) {
+		const ddTaskRecord_t* record = &records[i];
+		printf("Task: %u job %u %s %s at priority %u, released at %u with deadline: %u \n",
+				(unsigned int)record->id, (unsigned int)record->number,
+				(record->type == Periodic) ? "periodic" : "aperiodic", states[record->state],
+				(unsigned int)record->priority, (unsigned int)record->release, (unsigned int)record->deadline);
 	}
+	printf("\n");
+}
 
-	return;
+/*
+ * Prints the contents of the active task list
+ */
+void Get_Active_DD_TaskList(uint32_t totalDelay) {
+	printf("\n\nActive Tasks at %u: \n", (unsigned int)totalDelay);
+	for(uint32_t i = 0; i < DD_PARTITIONS; i++) {
+		Read_DD_Snapshot(i, &monitorSnapshot);
+		if(DD_PARTITIONS > 1) printf("Partition %u: ", (unsigned int)i);
+		Print_DD_Task_Records(monitorSnapshot.active, monitorSnapshot.activeLength);
+	}
 }
 
 /*
  * Prints the contents of the overdue task list
  */
 void Get_Overdue_DD_TaskList(uint32_t totalDelay) {
-	messageHandle overdueMessage = {OVERDUE_LIST, NULL, NULL};
-
-    // Send Message to scheduler queue
-    if(xSchedulerMessageQueue == NULL) return;
-	if(xQueueSend(xSchedulerMessageQueue, &overdueMessage, (TickType_t)portMAX_DELAY ) != pdPASS) return;
-
-    // Wait for the response data from the monitor queue
-    if(xMonitorMessageQueue == NULL) return;
-	if(xQueueReceive( xMonitorMessageQueue, &overdueMessage, (TickType_t) portMAX_DELAY) == pdTRUE) {
-		printf("Overdue Tasks at %u: \n%s\n", totalDelay, (char*)(overdueMessage.data));
-		vPortFree(overdueMessage.data);
-		overdueMessage.data = NULL;
+	printf("Overdue Tasks at %u: \n", (unsigned int)totalDelay);
+	for(uint32_t i = 0; i < DD_PARTITIONS; i++) {
+		Read_DD_Snapshot(i, &monitorSnapshot);
+		if(DD_PARTITIONS > 1) printf("Partition %u: ", (unsigned int)i);
+		Print_DD_Task_Records(monitorSnapshot.overdue, monitorSnapshot.overdueLength);
 	}
-
-    return;
 }
@@ -3,13 +3,28 @@
 
 #include <CommonConfig.h>
 #include <List.h>
+#include <Accounting.h>
+#include <Admission.h>
+#include <Resource.h>
+#include <Ring.h>
+#include <Wheel.h>
 
 void DD_Scheduler( void *pvParameters );
 void DD_Scheduler_Init( void );
+bool Send_DD_Command_FromISR(uint32_t partition, const messageHandle* message, BaseType_t* pxHigherPriorityTaskWoken);
 void Create_DD_Task(ddTaskHandle task);
-void Delete_DD_Task(TaskHandle_t task, char number);
+void Create_DD_Tasks(ddTaskHandle* tasks, uint32_t count);
+void Delete_DD_Task(ddTaskHandle task);
+bool Init_DD_Worker(ddWorkerHandle worker, TaskFunction_t function, const char* name, uint32_t partition);
+void Release_DD_Task(ddWorkerHandle worker, ddTaskHandle task);
+void Release_DD_Tasks(ddWorkerHandle* workers, ddTaskHandle* tasks, uint32_t count);
+void Complete_DD_Task(ddTaskHandle task);
+bool Lock_DD_Resource(ddResourceHandle resource, ddTaskHandle task);
+bool Unlock_DD_Resource(ddResourceHandle resource, ddTaskHandle task);
 void Monitor(void *pvParameters);
+void Read_DD_Snapshot(uint32_t partition, ddSnapshot_t* copy);
 void Get_Active_DD_TaskList(uint32_t totalDelay);
 void Get_Overdue_DD_TaskList(uint32_t totalDelay);
+void Print_DD_Statistics(void);
 
 #endif
@@ -0,0 +1,148 @@
+/*
+ * 	Timebase.c
+ *  Microsecond time base for job timestamps, a free-running 32-bit timer on target so the tick rate can stay at 1 kHz.
+ */
+
+#include <Timebase.h>
+#ifdef DD_HOST_SIMULATION
+#include <time.h>
+
+// Tick last seen by Get_DD_Simulated_Ns and the host time it was first seen at
+static TickType_t lastTick;
+static uint64_t lastTickTime;
+#else
+// Tick last marked by the tick interrupt and the timer count it started at, the timer is not in phase with SysTick
+static volatile TickType_t markTick;
+static volatile ddTimeUs_t markTime;
+#endif
+
+
+#ifdef DD_HOST_SIMULATION
+/*
+ * Returns nanoseconds of simulated time. The host tick timer runs late, so the count follows the tick count
+ * and the monotonic clock only fills in the time since the current tick was first seen, scaled to simulated time.
+ * Tasks and the switch hooks both call it, so the tick signal is masked while the tick anchor is read and moved.
+ */
+uint64_t Get_DD_Simulated_Ns(void) {
+	struct timespec now;
+	UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	uint64_t time = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+
+	TickType_t tick = xTaskGetTickCountFromISR();
+	if(tick != lastTick) {
+		lastTick = tick;
+		lastTickTime = time;
+	}
+
+	uint64_t elapsed = (time - lastTickTime) * DD_US_PER_TICK / configSIM_TICK_PERIOD_US;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+	if(elapsed >= DD_US_PER_TICK * 1000ULL) elapsed = DD_US_PER_TICK * 1000ULL - 1;
+	return (uint64_t)tick * DD_US_PER_TICK * 1000ULL + elapsed;
+}
+#endif
+
+#ifndef DD_HOST_SIMULATION
+/*
+ * Returns the prescaler that divides the timer's clock down to 1 MHz.
+ * Timers on APB1 run at twice PCLK1 whenever APB1 is divided down from HCLK.
+ */
+static uint16_t Get_DD_Timebase_Prescaler(void) {
+	RCC_ClocksTypeDef clocks;
+
+	RCC_GetClocksFreq(&clocks);
+	uint32_t timerClock = (clocks.PCLK1_Frequency == clocks.HCLK_Frequency) ? clocks.PCLK1_Frequency : clocks.PCLK1_Frequency * 2;
+	return (uint16_t)(timerClock / 1000000UL - 1);
+}
+#endif
+
+/*
+ * Starts the timer counting microseconds from 0 up to its full 32 bits, must run before the first job is released
+ */
+void Init_DD_Timebase(void) {
+#ifndef DD_HOST_SIMULATION
+	TIM_TimeBaseInitTypeDef timeBase;
+
+	RCC_APB1PeriphClockCmd(DD_TIMEBASE_CLOCK, ENABLE);
+	TIM_TimeBaseStructInit(&timeBase);
+	timeBase.TIM_Prescaler = Get_DD_Timebase_Prescaler();
+	timeBase.TIM_Period = 0xFFFFFFFF;
+	timeBase.TIM_ClockDivision = TIM_CKD_DIV1;
+	timeBase.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(DD_TIMEBASE_TIMER, &timeBase);
+	TIM_SetCounter(DD_TIMEBASE_TIMER, 0);
+	TIM_Cmd(DD_TIMEBASE_TIMER, ENABLE);
+	markTick = xTaskGetTickCount();
+	markTime = 0;
+#else
+	// Anchor on the first reading
+	lastTick = portMAX_DELAY;
+	lastTickTime = 0;
+#endif
+}
+
+/*
+ * Keeps the timer at 1 MHz after the APB1 clock changed. Loading the prescaler at once restarts the count,
+ * so the count is put back and the time base loses only the few cycles this takes.
+ */
+void Update_DD_Timebase(void) {
+#ifndef DD_HOST_SIMULATION
+	uint32_t count = DD_TIMEBASE_TIMER->CNT;
+	TIM_PrescalerConfig(DD_TIMEBASE_TIMER, Get_DD_Timebase_Prescaler(), TIM_PSCReloadMode_Immediate);
+	TIM_SetCounter(DD_TIMEBASE_TIMER, count);
+#endif
+}
+
+/*
+ * Returns the free-running microsecond count, which wraps after about 71 minutes so only differences are meaningful
+ */
+ddTimeUs_t Get_DD_Time_Us(void) {
+#ifndef DD_HOST_SIMULATION
+	return (ddTimeUs_t)DD_TIMEBASE_TIMER->CNT;
+#else
+	return (ddTimeUs_t)(Get_DD_Simulated_Ns() / 1000ULL);
+#endif
+}
+
+/*
+ * Tick interrupt hook, marks the timer count at the start of a tick. Only live ticks are marked, ticks the
+ * kernel replays after the scheduler was suspended are late.
+ */
+void Mark_DD_Tick(TickType_t tick) {
+#ifndef DD_HOST_SIMULATION
+	Mark_DD_Tick_At(tick, (ddTimeUs_t)DD_TIMEBASE_TIMER->CNT);
+#else
+	( void ) tick;
+#endif
+}
+
+/*
+ * Marks the timer count a tick started at when the tick interrupt did not run for it, as after tickless sleep
+ */
+void Mark_DD_Tick_At(TickType_t tick, ddTimeUs_t time) {
+#ifndef DD_HOST_SIMULATION
+	markTick = tick;
+	markTime = time;
+#else
+	( void ) tick;
+	( void ) time;
+#endif
+}
+
+/*
+ * Returns the time base count a tick started at, extrapolated from the last marked tick. The host time base
+ * follows the tick count, so its ticks start on whole multiples of DD_US_PER_TICK.
+ */
+ddTimeUs_t Get_DD_Tick_Time_Us(TickType_t tick) {
+#ifndef DD_HOST_SIMULATION
+	taskENTER_CRITICAL();
+	TickType_t since = markTick;
+	ddTimeUs_t time = markTime;
+	taskEXIT_CRITICAL();
+
+	return time + (ddTimeUs_t)(tick - since) * DD_US_PER_TICK;
+#else
+	return (ddTimeUs_t)((uint64_t)tick * DD_US_PER_TICK);
+#endif
+}
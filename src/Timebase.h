@@ -0,0 +1,16 @@
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <CommonConfig.h>
+
+#ifdef DD_HOST_SIMULATION
+uint64_t Get_DD_Simulated_Ns(void);
+#endif
+ddTimeUs_t Get_DD_Tick_Time_Us(TickType_t tick);
+ddTimeUs_t Get_DD_Time_Us(void);
+void Init_DD_Timebase(void);
+void Mark_DD_Tick(TickType_t tick);
+void Mark_DD_Tick_At(TickType_t tick, ddTimeUs_t time);
+void Update_DD_Timebase(void);
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * 	Wheel.c
+ *  Hashed timing wheel holding the pending job deadlines of the deadline-driven scheduler.
+ *  Releases are not scheduled here: the dispatcher in Creator.c keeps them in its release table sorted by
+ *  next release and sleeps until the head row, re-sorting one row per release (linear in the task set).
+ */
+
+#include <Wheel.h>
+
+#define DD_WHEEL_MASK		(DD_WHEEL_SLOTS - 1)
+
+/*
+ * Initializes an empty wheel whose last processed tick is now
+ */
+void Init_DD_Wheel(ddWheelHandle wheel, TickType_t now) {
+	// Confirm valid pointer
+	if(wheel == NULL) return;
+
+	wheel->length = 0;
+	wheel->now = now;
+	for(uint32_t i = 0; i < DD_WHEEL_WORDS; i++) wheel->occupied[i] = 0;
+	for(uint32_t i = 0; i < DD_WHEEL_SLOTS; i++) wheel->slots[i] = NULL;
+}
+
+/*
+ * Returns true if the event is waiting in the wheel
+ */
+bool Is_DD_Event_Armed(ddWheelHandle wheel, ddEventHandle event) {
+	if(wheel == NULL || event == NULL) return false;
+	return (event->previous != NULL || wheel->slots[event->expiry & DD_WHEEL_MASK] == event);
+}
+
+/*
+ * Adds an event at the head of its slot in O(1), an event already due fires on the next tick processed
+ */
+void Add_DD_Event(ddWheelHandle wheel, ddEventHandle event) {
+	// Catch bad inputs, including events that are already armed
+	if(wheel == NULL || event == NULL || Is_DD_Event_Armed(wheel, event)) return;
+
+	if(event->expiry <= wheel->now) event->expiry = wheel->now + 1;
+	uint32_t slot = event->expiry & DD_WHEEL_MASK;
+
+	event->previous = NULL;
+	event->next = wheel->slots[slot];
+	if(event->next != NULL) event->next->previous = event;
+	wheel->slots[slot] = event;
+
+	wheel->occupied[slot / 32] |= (1UL << (slot % 32));
+	wheel->length++;
+}
+
+/*
+ * Unlinks an armed event from its slot in O(1)
+ */
+void Remove_DD_Event(ddWheelHandle wheel, ddEventHandle event) {
+	// Catch bad inputs
+	if(!Is_DD_Event_Armed(wheel, event)) return;
+
+	uint32_t slot = event->expiry & DD_WHEEL_MASK;
+	if(event->previous != NULL) {
+		event->previous->next = event->next;
+	} else {
+		wheel->slots[slot] = event->next;
+	}
+	if(event->next != NULL) event->next->previous = event->previous;
+
+	event->next = NULL;
+	event->previous = NULL;
+	if(wheel->slots[slot] == NULL) wheel->occupied[slot / 32] &= ~(1UL << (slot % 32));
+	wheel->length--;
+}
+
+/*
+ * Moves the wheel up to now and returns the events that expired, chained through their next pointers.
+ * Each slot passed costs O(1) plus its events, and a gap longer than one round visits every slot once.
+ */
+ddEventHandle Advance_DD_Wheel(ddWheelHandle wheel, TickType_t now) {
+	// Confirm valid pointer and that time moved on
+	if(wheel == NULL || now <= wheel->now) return NULL;
+
+	ddEventHandle expired = NULL;
+	TickType_t ticks = now - wheel->now;
+	if(ticks > DD_WHEEL_SLOTS) ticks = DD_WHEEL_SLOTS;
+
+	for(TickType_t tick = wheel->now + 1; ticks > 0; tick++, ticks--) {
+		uint32_t slot = tick & DD_WHEEL_MASK;
+		if((wheel->occupied[slot / 32] & (1UL << (slot % 32))) == 0) continue;
+
+		// Events of a later round stay in the slot
+		ddEventHandle event = wheel->slots[slot];
+		while(event != NULL) {
+			ddEventHandle next = event->next;
+			if(event->expiry <= now) {
+				Remove_DD_Event(wheel, event);
+				event->next = expired;
+				expired = event;
+			}
+			event = next;
+		}
+	}
+
+	wheel->now = now;
+	return expired;
+}
+
+/*
+ * Returns the tick of the next non-empty slot, or portMAX_DELAY if the wheel is empty.
+ * The slot may only hold events of a later round, which costs one early wakeup.
+ */
+TickType_t Next_DD_Event(ddWheelHandle wheel) {
+	if(wheel == NULL || wheel->length == 0) return portMAX_DELAY;
+
+	uint32_t start = (wheel->now + 1) & DD_WHEEL_MASK;
+
+	// Scan the bitmap a word at a time from the slot after now, the last pass covers the wrapped part of the first word
+	for(uint32_t i = 0; i <= DD_WHEEL_WORDS; i++) {
+		uint32_t word = ((start / 32) + i) % DD_WHEEL_WORDS;
+		uint32_t bits = wheel->occupied[word];
+		if(i == 0) bits &= (0xFFFFFFFFUL << (start % 32));
+		if(i == DD_WHEEL_WORDS) bits &= ((1UL << (start % 32)) - 1);
+		if(bits == 0) continue;
+
+		uint32_t slot = (word * 32) + __builtin_ctz(bits);
+		return wheel->now + 1 + ((slot - start) & DD_WHEEL_MASK);
+	}
+	return portMAX_DELAY;
+}
@@ -0,0 +1,13 @@
+#ifndef WHEEL_H_
+#define WHEEL_H_
+
+#include <CommonConfig.h>
+
+void Add_DD_Event(ddWheelHandle wheel, ddEventHandle event);
+ddEventHandle Advance_DD_Wheel(ddWheelHandle wheel, TickType_t now);
+void Init_DD_Wheel(ddWheelHandle wheel, TickType_t now);
+bool Is_DD_Event_Armed(ddWheelHandle wheel, ddEventHandle event);
+TickType_t Next_DD_Event(ddWheelHandle wheel);
+void Remove_DD_Event(ddWheelHandle wheel, ddEventHandle event);
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * 	Workload.c
+ *  Synthetic CPU work for deadline-driven job bodies, calibrated so one tick of work costs one tick of CPU time.
+ */
+
+#include <Workload.h>
+#include <Governor.h>
+
+// Work units that take one tick of CPU time, measured by Calibrate_DD_Workload
+static uint32_t unitsPerTick;
+
+// Keeps the result of the work live so the compiler cannot drop it
+static volatile uint32_t workloadSink = 1;
+
+
+/*
+ * Runs a number of work units, each one xorshift step that depends on the one before
+ */
+static void Burn_DD_Work(uint32_t units) {
+	uint32_t x = workloadSink | 1;
+
+	for(uint32_t i = 0; i < units; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+	}
+	workloadSink = x;
+}
+
+/*
+ * Counts the work units done over DD_WORKLOAD_CALIBRATION_TICKS whole ticks. Must run from a task once the
+ * kernel is started and at a priority nothing else preempts for long, the tick interrupt's cost is included.
+ */
+void Calibrate_DD_Workload(void) {
+	uint32_t units = 0;
+
+	// Start on a tick edge so only whole ticks are measured
+	TickType_t start = xTaskGetTickCount();
+	while(xTaskGetTickCount() == start);
+	start = xTaskGetTickCount();
+
+	while(xTaskGetTickCount() - start < DD_WORKLOAD_CALIBRATION_TICKS) {
+		Burn_DD_Work(DD_WORKLOAD_CHUNK);
+		units += DD_WORKLOAD_CHUNK;
+	}
+
+	unitsPerTick = units / DD_WORKLOAD_CALIBRATION_TICKS;
+}
+
+/*
+ * Returns how many work units take one tick of CPU time, 0 until the workload is calibrated
+ */
+uint32_t Get_DD_Workload_Rate(void) {
+	return unitsPerTick;
+}
+
+/*
+ * Burns the CPU time a number of ticks take at full speed, time spent preempted does not count towards it.
+ * The host models a slower core clock by doing proportionally more work.
+ */
+void Run_DD_Workload(TickType_t ticks) {
+#ifndef DD_HOST_SIMULATION
+	uint32_t units = unitsPerTick;
+#else
+	uint32_t units = (uint32_t)((uint64_t)unitsPerTick * DD_FULL_SPEED_HZ / Get_DD_Core_Clock());
+#endif
+	for(TickType_t i = 0; i < ticks; i++) Burn_DD_Work(units);
+}
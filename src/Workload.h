@@ -0,0 +1,10 @@
+#ifndef WORKLOAD_H_
+#define WORKLOAD_H_
+
+#include <CommonConfig.h>
+
+void Calibrate_DD_Workload(void);
+uint32_t Get_DD_Workload_Rate(void);
+void Run_DD_Workload(TickType_t ticks);
+
+#endif
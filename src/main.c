@@ -72,51 +72,16 @@
 #include <Creator.h>
 #include <Scheduler.h>
 
-int queueSetup(void);
-
 /*
  * Initializes the deadline-driven tasks and starts the schedulers
  */
 int main(void) {
 
-	if(queueSetup() == 1) return 0;
     DD_Scheduler_Init();
 
-    xTaskCreate( PeriodicTaskCreator1 , "PeriodicCreator1"  , configMINIMAL_STACK_SIZE , NULL , GENERATOR_DD_PRIORITY , &PeriodicTaskCreatorHandle1);
-    xTaskCreate( PeriodicTaskCreator2 , "PeriodicCreator2"  , configMINIMAL_STACK_SIZE , NULL , GENERATOR_DD_PRIORITY , &PeriodicTaskCreatorHandle2);
-    xTaskCreate( PeriodicTaskCreator3 , "PeriodicCreator3"  , configMINIMAL_STACK_SIZE , NULL , GENERATOR_DD_PRIORITY , &PeriodicTaskCreatorHandle3);
-    //xTaskCreate( AperiodicTaskCreator , "AperiodicCreator" 	, configMINIMAL_STACK_SIZE , NULL , GENERATOR_DD_PRIORITY , &AperiodicTaskCreatorHandle);
+    Start_DD_TaskSet(ddTaskSet, ddTaskSetSize);
 
     vTaskStartScheduler();
 
     return 0;
 }
-
-/*
- * Initializes the necessary queues
- */
-int queueSetup(void) {
-	xTask1Queue = xQueueCreate(1, sizeof(uint16_t));
-	if(xTask1Queue == NULL) return 1;
-	vQueueAddToRegistry(xTask1Queue, "xTask1Queue");
-
-	xTask2Queue = xQueueCreate(1, sizeof(uint16_t));
-	if(xTask2Queue == NULL) return 1;
-	vQueueAddToRegistry(xTask2Queue, "xTask2Queue");
-
-	xTask3Queue = xQueueCreate(1, sizeof(uint16_t));
-	if(xTask3Queue == NULL) return 1;
-	vQueueAddToRegistry(xTask3Queue, "xTask3Queue");
-
-	xTaskAperiodicQueue = xQueueCreate(1, sizeof(uint16_t));
-	if(xTaskAperiodicQueue == NULL) return 1;
-	vQueueAddToRegistry(xTaskAperiodicQueue, "xTaskAperiodicQueue");
-
-	return 0;
-}
-
-
-
-
-
-